@@ -0,0 +1,559 @@
+#include "SimpleTrieSpellChecker.h"
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#include <time.h>
+#endif
+
+/* Regression benchmark, JSON output:
+ * - generates a deterministic synthetic dictionary (own PRNG, so the same
+ *   seed gives the same words on every platform) whose words are ranked by
+ *   a Zipf distribution,
+ * - measures the build (TrieInsert in rank order, TrieBuildParallel over
+ *   the same order on `build-threads` threads, TrieBuildFromSorted),
+ * - SearchTrie throughput over a Zipf-sampled query stream in which a
+ *   `typo-rate` fraction of the queries carry one random edit, and the
+ *   same stream through SearchTrieBatch in groups of 64 and SearchPacked,
+ * - SuggestCorrections latency per call (p50/p90/p99/p999 + a log2
+ *   histogram) over Zipf-sampled words with one random edit, and the
+ *   mean of SuggestCorrectionsPacked over the same queries,
+ * - the mean cost of such queries one by one (SuggestCorrectionsInto) and
+ *   in batches of 64 (SuggestCorrectionsBatch),
+ * - the same kind of queries with 5% junk tokens mixed in (long random
+ *   letters and digits), through SuggestCorrectionsInto and through
+ *   SuggestCorrectionsWithOptions with pre-filters and a node budget,
+ * - TrieComplete latency per call for 1-3 letter prefixes of Zipf-sampled
+ *   words, after giving every word its rank as a weight (rank 0 heaviest),
+ * - the trie's shape and heap bytes (TrieGetStats), the same words in a
+ *   PackedTrie (bytes per word before/after) and, when the library
+ *   is built with TRIE_COUNTERS, the suggestion DFS work per query,
+ * - peak RSS of the process, right after the incremental build and at exit.
+ *
+ * Usage: SimpleTrieSpellChecker_bench [--words N] [--zipf S] [--typo-rate R]
+ *            [--lookups N] [--suggests N] [--max-suggestions N] [--seed N]
+ *            [--build-threads N] [--out FILE]  */
+
+#define MAX_WORD 32
+#define BUCKETS  40
+#define GUARD_NODES 1024   /* node budget of the guarded suggestion run */
+
+typedef struct {
+    long words;
+    double zipf;
+    double typoRate;
+    long lookups;
+    long suggests;
+    int maxSuggestions;
+    unsigned long long seed;
+    int buildThreads;             /* TrieBuildParallel threads, 0 = one per CPU */
+    const char *out;
+} BenchConfig;
+
+/* ---- deterministic randomness ---------------------------------- */
+
+static uint64_t rngState;
+
+static uint64_t Next64(void) {                        /* splitmix64 */
+    uint64_t z = (rngState += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static unsigned Below(unsigned n) {
+    return (unsigned)(Next64() % n);
+}
+
+static double Uniform(void) {                         /* [0, 1) */
+    return (double)(Next64() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/* Letters weighted roughly like English text. */
+static const char LETTERS[] =
+    "EEEEEEEEEEEETTTTTTTTTAAAAAAAAOOOOOOOIIIIIIINNNNNNNSSSSSSHHHHHHRRRRRR"
+    "DDDDLLLLCCCUUUMMMWWFFGGYYPPBVKJXQZ";
+
+static char RandomLetter(void) {
+    return LETTERS[Below(sizeof(LETTERS) - 1)];
+}
+
+/* Word lengths 2..15, peaking at 7-8 like a general dictionary. */
+static int RandomLength(void) {
+    return 2 + (int)Below(7) + (int)Below(8);
+}
+
+/* Apply one random substitution / insertion / deletion / transposition. */
+static void Mutate(char *w) {
+    int n = (int)strlen(w);
+    int i = (int)Below((unsigned)n);
+    switch (Below(4)) {
+    case 0: w[i] = RandomLetter(); break;
+    case 1: if (n < MAX_WORD - 1) { memmove(w + i + 1, w + i, (size_t)(n - i + 1)); w[i] = RandomLetter(); } break;
+    case 2: if (n > 1) memmove(w + i, w + i + 1, (size_t)(n - i)); break;
+    default: if (i + 1 < n) { char t = w[i]; w[i] = w[i + 1]; w[i + 1] = t; } break;
+    }
+}
+
+/* A token no word is near: random letters with some digits mixed in, as
+ * in hashes or base64 fragments. */
+static void Junk(char *w) {
+    int n = 8 + (int)Below(MAX_WORD - 9);
+    for (int i = 0; i < n; ++i) w[i] = Below(8) ? RandomLetter() : (char)('0' + Below(10));
+    w[n] = '\0';
+}
+
+/* ---- timing and memory ----------------------------------------- */
+
+static uint64_t NowNs(void) {
+#if defined(_WIN32)
+    static LARGE_INTEGER freq;
+    LARGE_INTEGER t;
+    if (!freq.QuadPart) QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&t);
+    return (uint64_t)((double)t.QuadPart * 1e9 / (double)freq.QuadPart);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+static unsigned long long PeakRssBytes(void) {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS pmc;
+    return GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))
+        ? (unsigned long long)pmc.PeakWorkingSetSize : 0;
+#else
+    struct rusage ru;
+    if (getrusage(RUSAGE_SELF, &ru) != 0) return 0;
+#if defined(__APPLE__)
+    return (unsigned long long)ru.ru_maxrss;          /* bytes */
+#else
+    return (unsigned long long)ru.ru_maxrss * 1024u;  /* kilobytes */
+#endif
+#endif
+}
+
+/* ---- dictionary ------------------------------------------------ */
+
+/* words[r] is the word of Zipf rank r; cdf[r] = P(rank <= r). */
+typedef struct {
+    char (*words)[MAX_WORD];
+    double *cdf;
+    long n;
+} Dictionary;
+
+static uint32_t HashWord(const char *w) {
+    uint32_t h = 2166136261u;                         /* FNV-1a */
+    for (; *w; ++w) { h ^= (unsigned char)*w; h *= 16777619u; }
+    return h;
+}
+
+static void GenerateDictionary(Dictionary *d, long n, double s) {
+    size_t slots = 1;
+    while (slots < (size_t)n * 2) slots <<= 1;
+    long *set = (long*)malloc(slots * sizeof(long));  /* rank + 1, 0 = empty */
+    d->words = (char (*)[MAX_WORD])malloc((size_t)n * MAX_WORD);
+    d->cdf = (double*)malloc((size_t)n * sizeof(double));
+    if (!set || !d->words || !d->cdf) Error("out of memory: bench dictionary");
+    memset(set, 0, slots * sizeof(long));
+    d->n = n;
+
+    for (long r = 0; r < n; ) {
+        char *w = d->words[r];
+        int len = RandomLength();
+        for (int i = 0; i < len; ++i) w[i] = RandomLetter();
+        w[len] = '\0';
+
+        size_t j = HashWord(w) & (slots - 1);
+        while (set[j] && strcmp(d->words[set[j] - 1], w) != 0) j = (j + 1) & (slots - 1);
+        if (set[j]) continue;                         /* duplicate: draw again */
+        set[j] = ++r;
+    }
+    free(set);
+
+    double sum = 0;
+    for (long r = 0; r < n; ++r) d->cdf[r] = (sum += 1.0 / pow((double)(r + 1), s));
+    for (long r = 0; r < n; ++r) d->cdf[r] /= sum;
+}
+
+static long ZipfRank(const Dictionary *d) {
+    double u = Uniform();
+    long lo = 0, hi = d->n - 1;
+    while (lo < hi) {
+        long mid = lo + (hi - lo) / 2;
+        if (d->cdf[mid] < u) lo = mid + 1; else hi = mid;
+    }
+    return lo;
+}
+
+static int CompareStrings(const void *a, const void *b) {
+    return strcmp(*(const char *const *)a, *(const char *const *)b);
+}
+
+/* ---- latency statistics ---------------------------------------- */
+
+static int CompareU64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static uint64_t Percentile(const uint64_t *sorted, long n, double p) {
+    long i = (long)ceil(p * (double)n) - 1;
+    return sorted[i < 0 ? 0 : (i >= n ? n - 1 : i)];
+}
+
+static void PrintLatency(FILE *out, uint64_t *ns, long n) {
+    long hist[BUCKETS] = { 0 };
+    double sum = 0;
+    int low = BUCKETS, top = 0;
+
+    qsort(ns, (size_t)n, sizeof(uint64_t), CompareU64);
+    for (long i = 0; i < n; ++i) {
+        int b = 0;
+        while (b < BUCKETS - 1 && ns[i] >= (2ull << b)) ++b;   /* [2^b, 2^(b+1)) */
+        ++hist[b];
+        if (b < low) low = b;
+        if (b > top) top = b;
+        sum += (double)ns[i];
+    }
+
+    fprintf(out, "      \"min_ns\": %llu,\n", (unsigned long long)ns[0]);
+    fprintf(out, "      \"mean_ns\": %.1f,\n", sum / (double)n);
+    fprintf(out, "      \"p50_ns\": %llu,\n", (unsigned long long)Percentile(ns, n, 0.50));
+    fprintf(out, "      \"p90_ns\": %llu,\n", (unsigned long long)Percentile(ns, n, 0.90));
+    fprintf(out, "      \"p99_ns\": %llu,\n", (unsigned long long)Percentile(ns, n, 0.99));
+    fprintf(out, "      \"p999_ns\": %llu,\n", (unsigned long long)Percentile(ns, n, 0.999));
+    fprintf(out, "      \"max_ns\": %llu,\n", (unsigned long long)ns[n - 1]);
+    fprintf(out, "      \"histogram\": [");
+    for (int b = low; b <= top; ++b)                  /* log2 buckets, non-empty range */
+        fprintf(out, "%s\n        { \"ge_ns\": %llu, \"lt_ns\": %llu, \"count\": %ld }",
+                b > low ? "," : "", b ? 1ull << b : 0ull, 2ull << b, hist[b]);
+    fprintf(out, "\n      ]\n");
+}
+
+/* ---- driver ---------------------------------------------------- */
+
+static void Usage(void) {
+    fprintf(stderr,
+        "usage: SimpleTrieSpellChecker_bench [--words N] [--zipf S] [--typo-rate R]\n"
+        "           [--lookups N] [--suggests N] [--max-suggestions N] [--seed N]\n"
+        "           [--build-threads N] [--out FILE]\n");
+    exit(2);
+}
+
+static void ParseArgs(int argc, char **argv, BenchConfig *c) {
+    for (int i = 1; i < argc; ++i) {
+        const char *opt = argv[i];
+        if (i + 1 >= argc) Usage();
+        const char *v = argv[++i];
+        if      (strcmp(opt, "--words") == 0)           c->words = atol(v);
+        else if (strcmp(opt, "--zipf") == 0)            c->zipf = atof(v);
+        else if (strcmp(opt, "--typo-rate") == 0)       c->typoRate = atof(v);
+        else if (strcmp(opt, "--lookups") == 0)         c->lookups = atol(v);
+        else if (strcmp(opt, "--suggests") == 0)        c->suggests = atol(v);
+        else if (strcmp(opt, "--max-suggestions") == 0) c->maxSuggestions = atoi(v);
+        else if (strcmp(opt, "--seed") == 0)            c->seed = strtoull(v, NULL, 10);
+        else if (strcmp(opt, "--build-threads") == 0)   c->buildThreads = atoi(v);
+        else if (strcmp(opt, "--out") == 0)             c->out = v;
+        else Usage();
+    }
+    if (c->words < 1 || c->lookups < 1 || c->suggests < 1 || c->zipf < 0
+        || c->typoRate < 0 || c->typoRate > 1 || c->buildThreads < 0) Usage();
+}
+
+int main(int argc, char **argv) {
+    BenchConfig cfg = { 100000, 1.0, 0.05, 2000000, 20000, 10, 1, 0, NULL };
+    ParseArgs(argc, argv, &cfg);
+    rngState = cfg.seed;
+
+    Dictionary dict;
+    GenerateDictionary(&dict, cfg.words, cfg.zipf);
+
+    /* build: incremental inserts in rank order, then the sorted bulk path */
+    uint64_t t0 = NowNs();
+    NonLeafPtr root = TrieCreateWithFirstWord(dict.words[0]);
+    for (long r = 1; r < dict.n; ++r) TrieInsert(dict.words[r], root);
+    double insertS = (double)(NowNs() - t0) / 1e9;
+    unsigned long long builtRss = PeakRssBytes();
+    TrieStats stats;
+    TrieGetStats(root, &stats);
+
+    const char **sorted = (const char**)malloc((size_t)dict.n * sizeof(char*));
+    if (!sorted) Error("out of memory: bench");
+    for (long r = 0; r < dict.n; ++r) sorted[r] = dict.words[r];
+    t0 = NowNs();
+    NonLeafPtr sharded = TrieBuildParallel(sorted, (size_t)dict.n, cfg.buildThreads);
+    double parallelS = (double)(NowNs() - t0) / 1e9;
+    TrieDestroy(sharded);
+
+    qsort(sorted, (size_t)dict.n, sizeof(char*), CompareStrings);
+    t0 = NowNs();
+    NonLeafPtr bulk = TrieBuildFromSorted(sorted, (size_t)dict.n, NULL);
+    double bulkS = (double)(NowNs() - t0) / 1e9;
+    TrieDestroy(bulk);
+    free(sorted);
+
+    /* the same words in the packed encoding, inserted in rank order too */
+    t0 = NowNs();
+    PackedTrie *packed = PackedTrieCreate();
+    for (long r = 0; r < dict.n; ++r) PackedTrieInsert(packed, dict.words[r]);
+    double packedS = (double)(NowNs() - t0) / 1e9;
+    PackedTrieTrim(packed);
+
+    /* lookups: Zipf-sampled words, `typoRate` of them with one edit;
+       generated in chunks so the stream does not inflate the RSS */
+    static char chunk[4096][MAX_WORD];
+    static const char *chunkWords[4096];
+    static int chunkResults[4096];
+    long typos = 0, hits = 0, batchHits = 0, packedHits = 0;
+    uint64_t lookupNs = 0, batchNs = 0, packedNs = 0;
+    for (long done = 0; done < cfg.lookups; ) {
+        long n = cfg.lookups - done < 4096 ? cfg.lookups - done : 4096;
+        for (long i = 0; i < n; ++i) {
+            memcpy(chunk[i], dict.words[ZipfRank(&dict)], MAX_WORD);
+            if (Uniform() < cfg.typoRate) { Mutate(chunk[i]); ++typos; }
+        }
+        t0 = NowNs();
+        for (long i = 0; i < n; ++i) hits += SearchTrie(root, chunk[i]) == success;
+        lookupNs += NowNs() - t0;
+
+        for (long i = 0; i < n; ++i) chunkWords[i] = chunk[i];
+        t0 = NowNs();
+        for (long i = 0; i < n; i += 64)
+            SearchTrieBatch(root, chunkWords + i, (size_t)(n - i < 64 ? n - i : 64), chunkResults + i);
+        batchNs += NowNs() - t0;
+        for (long i = 0; i < n; ++i) batchHits += chunkResults[i] == success;
+
+        t0 = NowNs();
+        for (long i = 0; i < n; ++i) packedHits += SearchPacked(packed, chunk[i]) == success;
+        packedNs += NowNs() - t0;
+        done += n;
+    }
+    double lookupS = (double)lookupNs / 1e9;
+    if (batchHits != hits) Error("SearchTrieBatch disagrees with SearchTrie");
+    if (packedHits != hits) Error("SearchPacked disagrees with SearchTrie");
+
+    /* suggestions: Zipf-sampled words with one edit, timed per call */
+    uint64_t *lat = (uint64_t*)malloc((size_t)cfg.suggests * sizeof(uint64_t));
+    if (!lat) Error("out of memory: bench");
+    long returned = 0, packedReturned = 0;
+    uint64_t packedSuggestNs = 0;
+    TrieCounters counters;
+    TrieCountersReset();
+    for (long i = 0; i < cfg.suggests; ++i) {
+        char q[MAX_WORD];
+        SuggestBox box;
+        memcpy(q, dict.words[ZipfRank(&dict)], MAX_WORD);
+        Mutate(q);
+        uint64_t s0 = NowNs();
+        SuggestCorrections(root, q, cfg.maxSuggestions, &box);
+        lat[i] = NowNs() - s0;
+        returned += box.count;
+        FreeSuggestBox(&box);
+
+        s0 = NowNs();
+        SuggestCorrectionsPacked(packed, q, cfg.maxSuggestions, &box);
+        packedSuggestNs += NowNs() - s0;
+        packedReturned += box.count;
+        FreeSuggestBox(&box);
+    }
+    int counted = TrieCountersGet(&counters);
+    if (packedReturned != returned) Error("SuggestCorrectionsPacked disagrees with SuggestCorrections");
+
+    /* the same kind of queries one at a time vs. in batches of 64 */
+    char (*typoQ)[MAX_WORD] = (char(*)[MAX_WORD])malloc((size_t)cfg.suggests * MAX_WORD);
+    const char **typoWords = (const char**)malloc((size_t)cfg.suggests * sizeof(char*));
+    SuggestResult *batchOut = (SuggestResult*)malloc(64 * sizeof(SuggestResult));
+    if (!typoQ || !typoWords || !batchOut) Error("out of memory: bench");
+    for (long i = 0; i < cfg.suggests; ++i) {
+        memcpy(typoQ[i], dict.words[ZipfRank(&dict)], MAX_WORD);
+        Mutate(typoQ[i]);
+        typoWords[i] = typoQ[i];
+    }
+    SuggestResult single;
+    SuggestResultInit(&single);
+    for (int i = 0; i < 64; ++i) SuggestResultInit(&batchOut[i]);
+    long singleReturned = 0, batchReturned = 0;
+    t0 = NowNs();
+    for (long i = 0; i < cfg.suggests; ++i) {
+        SuggestCorrectionsInto(root, typoQ[i], cfg.maxSuggestions, &single);
+        singleReturned += single.count;
+    }
+    uint64_t singleNs = NowNs() - t0;
+    t0 = NowNs();
+    for (long i = 0; i < cfg.suggests; i += 64) {
+        long n = cfg.suggests - i < 64 ? cfg.suggests - i : 64;
+        SuggestCorrectionsBatch(root, typoWords + i, (size_t)n, cfg.maxSuggestions, batchOut);
+        for (long j = 0; j < n; ++j) batchReturned += batchOut[j].count;
+    }
+    uint64_t batchSuggestNs = NowNs() - t0;
+    if (batchReturned != singleReturned) Error("SuggestCorrectionsBatch disagrees with SuggestCorrectionsInto");
+    for (int i = 0; i < 64; ++i) SuggestResultFree(&batchOut[i]);
+    SuggestResultFree(&single);
+    free(batchOut);
+    free(typoWords);
+    free(typoQ);
+
+    /* junk-laden queries: unguarded vs. pre-filters + node budget */
+    uint64_t *plainLat = (uint64_t*)malloc((size_t)cfg.suggests * sizeof(uint64_t));
+    uint64_t *guardLat = (uint64_t*)malloc((size_t)cfg.suggests * sizeof(uint64_t));
+    if (!plainLat || !guardLat) Error("out of memory: bench");
+    SuggestOptions opts;
+    SuggestOptionsInit(&opts, root);
+    opts.maxNodes = GUARD_NODES;
+    SuggestResult plain, guarded;
+    SuggestResultInit(&plain);
+    SuggestResultInit(&guarded);
+    char (*junkQ)[MAX_WORD] = (char(*)[MAX_WORD])malloc((size_t)cfg.suggests * MAX_WORD);
+    if (!junkQ) Error("out of memory: bench");
+    long truncated = 0, junk = 0;
+    for (long i = 0; i < cfg.suggests; ++i) {
+        if (Uniform() < 0.05) {
+            Junk(junkQ[i]);
+            ++junk;
+        } else {
+            memcpy(junkQ[i], dict.words[ZipfRank(&dict)], MAX_WORD);
+            Mutate(junkQ[i]);
+        }
+    }
+    for (long i = 0; i < cfg.suggests; ++i) {
+        uint64_t s0 = NowNs();
+        SuggestCorrectionsInto(root, junkQ[i], cfg.maxSuggestions, &plain);
+        plainLat[i] = NowNs() - s0;
+    }
+    for (long i = 0; i < cfg.suggests; ++i) {
+        uint64_t s0 = NowNs();
+        SuggestCorrectionsWithOptions(root, junkQ[i], cfg.maxSuggestions, &opts, &guarded);
+        guardLat[i] = NowNs() - s0;
+        truncated += guarded.truncated;
+    }
+    free(junkQ);
+    SuggestResultFree(&plain);
+    SuggestResultFree(&guarded);
+
+    /* completions: weights by rank (the words exist, so no new nodes),
+       then short prefixes of Zipf-sampled words, timed per call */
+    for (long r = 0; r < dict.n; ++r)
+        TrieInsertWeighted(dict.words[r], (unsigned int)(dict.n - r), root);
+    uint64_t *completeLat = (uint64_t*)malloc((size_t)cfg.suggests * sizeof(uint64_t));
+    if (!completeLat) Error("out of memory: bench");
+    SuggestResult completions;
+    SuggestResultInit(&completions);
+    long completed = 0;
+    for (long i = 0; i < cfg.suggests; ++i) {
+        char q[MAX_WORD];
+        memcpy(q, dict.words[ZipfRank(&dict)], MAX_WORD);
+        q[1 + i % 3] = '\0';
+        uint64_t s0 = NowNs();
+        TrieComplete(root, q, cfg.maxSuggestions, &completions);
+        completeLat[i] = NowNs() - s0;
+        completed += completions.count;
+    }
+    SuggestResultFree(&completions);
+
+    FILE *out = cfg.out ? fopen(cfg.out, "w") : stdout;
+    if (!out) Error("can't open output file");
+    fprintf(out, "{\n");
+    fprintf(out, "  \"benchmark\": \"SimpleTrieSpellChecker_bench\",\n");
+    fprintf(out, "  \"schema\": 1,\n");
+    fprintf(out, "  \"config\": {\n");
+    fprintf(out, "    \"words\": %ld,\n", cfg.words);
+    fprintf(out, "    \"zipf\": %.3f,\n", cfg.zipf);
+    fprintf(out, "    \"typo_rate\": %.4f,\n", cfg.typoRate);
+    fprintf(out, "    \"lookups\": %ld,\n", cfg.lookups);
+    fprintf(out, "    \"suggests\": %ld,\n", cfg.suggests);
+    fprintf(out, "    \"max_suggestions\": %d,\n", cfg.maxSuggestions);
+    fprintf(out, "    \"seed\": %llu,\n", cfg.seed);
+    fprintf(out, "    \"build_threads\": %d\n", cfg.buildThreads);
+    fprintf(out, "  },\n");
+    fprintf(out, "  \"build\": {\n");
+    fprintf(out, "    \"insert_s\": %.6f,\n", insertS);
+    fprintf(out, "    \"bulk_sorted_s\": %.6f,\n", bulkS);
+    fprintf(out, "    \"parallel_s\": %.6f,\n", parallelS);
+    fprintf(out, "    \"packed_insert_s\": %.6f\n", packedS);
+    fprintf(out, "  },\n");
+    fprintf(out, "  \"trie\": {\n");
+    fprintf(out, "    \"non_leaves\": %zu,\n", stats.nonLeaves);
+    fprintf(out, "    \"leaves\": %zu,\n", stats.leaves);
+    fprintf(out, "    \"edges\": %zu,\n", stats.edges);
+    fprintf(out, "    \"max_depth\": %zu,\n", stats.maxDepth);
+    fprintf(out, "    \"suffix_bytes\": %zu,\n", stats.suffixBytes);
+    fprintf(out, "    \"heap_bytes\": %zu,\n", stats.heapBytes);
+    fprintf(out, "    \"bytes_per_word\": %.2f\n", (double)stats.heapBytes / (double)stats.words);
+    fprintf(out, "  },\n");
+    fprintf(out, "  \"packed\": {\n");
+    fprintf(out, "    \"heap_bytes\": %zu,\n", PackedTrieBytes(packed));
+    fprintf(out, "    \"bytes_per_word\": %.2f,\n", (double)PackedTrieBytes(packed) / (double)stats.words);
+    fprintf(out, "    \"ns_per_op\": %.2f,\n", (double)packedNs / (double)cfg.lookups);
+    fprintf(out, "    \"suggest_mean_ns\": %.1f\n", (double)packedSuggestNs / (double)cfg.suggests);
+    fprintf(out, "  },\n");
+    fprintf(out, "  \"search\": {\n");
+    fprintf(out, "    \"queries\": %ld,\n", cfg.lookups);
+    fprintf(out, "    \"typos\": %ld,\n", typos);
+    fprintf(out, "    \"hits\": %ld,\n", hits);
+    fprintf(out, "    \"seconds\": %.6f,\n", lookupS);
+    fprintf(out, "    \"ns_per_op\": %.2f,\n", lookupS * 1e9 / (double)cfg.lookups);
+    fprintf(out, "    \"mops_per_s\": %.3f,\n", (double)cfg.lookups / lookupS / 1e6);
+    fprintf(out, "    \"batch64_ns_per_op\": %.2f\n", (double)batchNs / (double)cfg.lookups);
+    fprintf(out, "  },\n");
+    fprintf(out, "  \"suggest\": {\n");
+    fprintf(out, "    \"queries\": %ld,\n", cfg.suggests);
+    fprintf(out, "    \"suggestions\": %ld,\n", returned);
+    if (counted) {
+        fprintf(out, "    \"nodes_per_query\": %.1f,\n",
+                (double)counters.suggestNodes / (double)cfg.suggests);
+        fprintf(out, "    \"tail_compares_per_query\": %.1f,\n",
+                (double)counters.tailCompares / (double)cfg.suggests);
+    }
+    fprintf(out, "    \"into_ns_per_query\": %.1f,\n", (double)singleNs / (double)cfg.suggests);
+    fprintf(out, "    \"batch64_ns_per_query\": %.1f,\n", (double)batchSuggestNs / (double)cfg.suggests);
+    fprintf(out, "    \"latency\": {\n");
+    PrintLatency(out, lat, cfg.suggests);
+    fprintf(out, "    }\n");
+    fprintf(out, "  },\n");
+    fprintf(out, "  \"suggest_junk\": {\n");
+    fprintf(out, "    \"queries\": %ld,\n", cfg.suggests);
+    fprintf(out, "    \"junk\": %ld,\n", junk);
+    fprintf(out, "    \"max_nodes\": %d,\n", GUARD_NODES);
+    fprintf(out, "    \"truncated\": %ld,\n", truncated);
+    fprintf(out, "    \"unguarded_latency\": {\n");
+    PrintLatency(out, plainLat, cfg.suggests);
+    fprintf(out, "    },\n");
+    fprintf(out, "    \"guarded_latency\": {\n");
+    PrintLatency(out, guardLat, cfg.suggests);
+    fprintf(out, "    }\n");
+    fprintf(out, "  },\n");
+    fprintf(out, "  \"complete\": {\n");
+    fprintf(out, "    \"queries\": %ld,\n", cfg.suggests);
+    fprintf(out, "    \"completions\": %ld,\n", completed);
+    fprintf(out, "    \"latency\": {\n");
+    PrintLatency(out, completeLat, cfg.suggests);
+    fprintf(out, "    }\n");
+    fprintf(out, "  },\n");
+    fprintf(out, "  \"memory\": {\n");
+    fprintf(out, "    \"peak_rss_after_build_bytes\": %llu,\n", builtRss);
+    fprintf(out, "    \"peak_rss_bytes\": %llu\n", PeakRssBytes());
+    fprintf(out, "  }\n");
+    fprintf(out, "}\n");
+    if (out != stdout) fclose(out);
+
+    free(lat);
+    free(completeLat);
+    free(plainLat);
+    free(guardLat);
+    PackedTrieDestroy(packed);
+    TrieDestroy(root);
+    free(dict.words);
+    free(dict.cdf);
+    return 0;
+}
@@ -0,0 +1,75 @@
+#include "SimpleTrieSpellChecker.h"
+#include "TrieNode.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Microbenchmark for child lookup:
+ * - builds a trie whose root has `fan` outgoing edges,
+ * - resolves a fixed stream of random labels (hits and misses),
+ * - compares Position() with the original strlen + linear scan.
+ *
+ * Usage: SimpleTrieSpellChecker_position_bench [lookups]  */
+
+#define ALPHABET "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789'-"
+#define QUERIES  4096
+
+/* The pre-count implementation, kept verbatim for comparison. */
+static int LinearPosition(const char *letters, char ch) {
+    int len = (int)strlen(letters);
+    for (int i = 0; i < len; ++i)
+        if (letters[i] == ch) return i;
+    return notFound;
+}
+
+static double Seconds(clock_t from) {
+    return (double)(clock() - from) / CLOCKS_PER_SEC;
+}
+
+int main(int argc, char **argv) {
+    static const int fans[] = { 2, 4, 8, 12, 16, 20, 26, 32, 48, 64 };
+    long lookups = argc > 1 ? atol(argv[1]) : 50000000L;
+    char queries[QUERIES];
+
+    srand(12345);
+    for (int i = 0; i < QUERIES; ++i)
+        queries[i] = ALPHABET[rand() % (int)(sizeof(ALPHABET) - 1)];
+
+    printf("%6s %14s %14s %8s\n", "fanout", "linear ns/op", "Position ns/op", "speedup");
+    for (size_t f = 0; f < sizeof(fans) / sizeof(fans[0]); ++f) {
+        int fan = fans[f];
+        char word[3] = { 0, 'X', '\0' };
+        char letters[sizeof(ALPHABET)];
+
+        word[0] = ALPHABET[0];
+        NonLeafPtr root = TrieCreateWithFirstWord(word);
+        for (int i = 1; i < fan; ++i) {
+            word[0] = ALPHABET[i];
+            TrieInsert(word, root);
+        }
+        memcpy(letters, root->letters, root->count);
+        letters[root->count] = '\0';
+
+        long sumLinear = 0, sumFast = 0;
+        clock_t t0 = clock();
+        for (long i = 0; i < lookups; ++i)
+            sumLinear += LinearPosition(letters, queries[i & (QUERIES - 1)]);
+        double linear = Seconds(t0);
+
+        t0 = clock();
+        for (long i = 0; i < lookups; ++i)
+            sumFast += Position(root, queries[i & (QUERIES - 1)]);
+        double fast = Seconds(t0);
+
+        if (sumLinear != sumFast) {
+            printf("fan-out %d: results differ (%ld vs %ld)\n", fan, sumLinear, sumFast);
+            return 1;
+        }
+        printf("%6d %14.2f %14.2f %7.2fx\n", fan,
+               linear * 1e9 / (double)lookups, fast * 1e9 / (double)lookups,
+               fast > 0 ? linear / fast : 0.0);
+        TrieDestroy(root);
+    }
+    return 0;
+}
@@ -0,0 +1,145 @@
+#include "SimpleTrieSpellChecker.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Suggestion engine benchmark:
+ * - builds a trie from a word list (or a deterministic synthetic one),
+ * - derives misspelled queries by applying 1-2 random edits to words,
+ * - times the trie engines (SuggestCorrections, SuggestCorrectionsK)
+ *   against the deletion index (SuggestCorrectionsIndexed) for k = 1, 2,
+ *   and reports the index build time and memory cost.
+ *
+ * Usage: SimpleTrieSpellChecker_suggest_bench [dictionary|-] [words] [prefixLength]
+ *   "-" (default) generates `words` (default 200000) synthetic words. */
+
+#define QUERIES  2000
+#define MAX_SUGG 10
+
+/* Letters weighted roughly like English text. */
+static const char LETTERS[] =
+    "EEEEEEEEEEEETTTTTTTTTAAAAAAAAOOOOOOOIIIIIIINNNNNNNSSSSSSHHHHHHRRRRRR"
+    "DDDDLLLLCCCUUUMMMWWFFGGYYPPBVKJXQZ";
+
+static char RandomLetter(void) {
+    return LETTERS[rand() % (int)(sizeof(LETTERS) - 1)];
+}
+
+static double Seconds(clock_t from) {
+    return (double)(clock() - from) / CLOCKS_PER_SEC;
+}
+
+/* Apply one random substitution / insertion / deletion / transposition. */
+static void Mutate(char *w) {
+    int n = (int)strlen(w);
+    int i = rand() % n;
+    switch (rand() % 4) {
+    case 0: w[i] = RandomLetter(); break;
+    case 1: if (n < 60) { memmove(w + i + 1, w + i, (size_t)(n - i + 1)); w[i] = RandomLetter(); } break;
+    case 2: if (n > 1) memmove(w + i, w + i + 1, (size_t)(n - i)); break;
+    default: if (i + 1 < n) { char t = w[i]; w[i] = w[i + 1]; w[i + 1] = t; } break;
+    }
+}
+
+typedef void (*TrieEngine)(NonLeafPtr, const char *, int, SuggestBox *);
+
+static void Engine1(NonLeafPtr root, const char *w, int k, SuggestBox *box) {
+    (void)k;
+    SuggestCorrections(root, w, MAX_SUGG, box);
+}
+
+static void EngineK(NonLeafPtr root, const char *w, int k, SuggestBox *box) {
+    SuggestCorrectionsK(root, w, k, MAX_SUGG, box);
+}
+
+static double TimeTrie(TrieEngine fn, NonLeafPtr root, char (*q)[64], int k, long *found) {
+    clock_t t0 = clock();
+    for (int i = 0; i < QUERIES; ++i) {
+        SuggestBox box;
+        fn(root, q[i], k, &box);
+        *found += box.count;
+        FreeSuggestBox(&box);
+    }
+    return Seconds(t0) * 1e6 / QUERIES;
+}
+
+static double TimeIndex(const DeleteIndex *ix, char (*q)[64], int k, long *found) {
+    clock_t t0 = clock();
+    for (int i = 0; i < QUERIES; ++i) {
+        SuggestBox box;
+        SuggestCorrectionsIndexed(ix, q[i], k, MAX_SUGG, &box);
+        *found += box.count;
+        FreeSuggestBox(&box);
+    }
+    return Seconds(t0) * 1e6 / QUERIES;
+}
+
+int main(int argc, char **argv) {
+    const char *path = argc > 1 ? argv[1] : "-";
+    long target = argc > 2 ? atol(argv[2]) : 200000L;
+    int prefixLength = argc > 3 ? atoi(argv[3]) : 7;
+    static char queries[QUERIES][64];
+    char word[64];
+    char (*words)[64] = NULL;
+    long n = 0, cap = 0;
+    NonLeafPtr root = NULL;
+
+    srand(12345);
+    FILE *f = strcmp(path, "-") ? fopen(path, "r") : NULL;
+    if (strcmp(path, "-") && !f) Error("can't open dictionary");
+
+    /* words: from the file, or random 3..14 letter strings */
+    while (f ? fscanf(f, "%63s", word) == 1 : n < target) {
+        if (!f) {
+            int len = 3 + rand() % 12;
+            for (int i = 0; i < len; ++i) word[i] = RandomLetter();
+            word[len] = '\0';
+        }
+        strupr_local(word);
+        if (n == cap) {
+            cap = cap ? cap * 2 : 4096;
+            words = (char (*)[64])realloc(words, (size_t)cap * sizeof(*words));
+            if (!words) Error("out of memory");
+        }
+        memcpy(words[n++], word, sizeof(word));
+    }
+    if (f) fclose(f);
+    if (n == 0) Error("empty dictionary");
+
+    clock_t t0 = clock();
+    root = TrieCreateWithFirstWord(words[0]);
+    for (long i = 1; i < n; ++i) TrieInsert(words[i], root);
+    printf("dictionary: %ld words, trie built in %.2f s\n", n, Seconds(t0));
+
+    for (int i = 0; i < QUERIES; ++i) {
+        memcpy(queries[i], words[rand() % n], sizeof(queries[i]));
+        Mutate(queries[i]);
+        if (rand() % 2) Mutate(queries[i]);
+    }
+
+    printf("%-28s %10s %12s %12s\n", "engine", "build s", "index MB", "us/query");
+    for (int k = 1; k <= 2; ++k) {
+        long found = 0, foundIx = 0;
+        double trie = TimeTrie(k == 1 ? Engine1 : EngineK, root, queries, k, &found);
+
+        t0 = clock();
+        DeleteIndex *ix = DeleteIndexBuild(root, k, prefixLength);
+        double build = Seconds(t0);
+        double indexed = TimeIndex(ix, queries, k, &foundIx);
+
+        char label[64];
+        snprintf(label, sizeof(label), "deletion index (k=%d, p=%d)", k, prefixLength);
+        printf("%-28s %10s %12s %12.1f\n",
+               k == 1 ? "trie DFS (k=1)" : "trie DP row (k=2)", "-", "-", trie);
+        printf("%-28s %10.2f %12.1f %12.1f\n", label,
+               build, (double)DeleteIndexBytes(ix) / (1 << 20), indexed);
+        if (k == 2 && found != foundIx)
+            printf("  result counts differ: %ld vs %ld\n", found, foundIx);
+        DeleteIndexDestroy(ix);
+    }
+
+    TrieDestroy(root);
+    free(words);
+    return 0;
+}
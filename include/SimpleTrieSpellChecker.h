@@ -6,7 +6,8 @@
  *                                                                  *
  * Data model:                                                      *
  * - Non-leaf node keeps a sorted array of outgoing edge labels     *
- *   (`letters`) and a parallel array of child pointers (`ptrs`).   *
+ *   (`letters`, `count` entries) and a parallel array of child     *
+ *   pointers (`ptrs`).                                             *
  * - Leaf node stores the ENTIRE remaining suffix of a dictionary   *
  *   word (possibly ""), i.e., path compression at the last hop.    *
  *                                                                  *
@@ -38,13 +39,17 @@ typedef struct LeafNode *LeafPtr;
 struct NonLeafNode {
     unsigned int kind      : 1;   /* 0 => non-leaf, 1 => leaf */
     unsigned int EndOfWord : 1;   /* marks end of a word exactly at this node */
-    char *letters;                /* sorted distinct edge labels */
+    unsigned int count     : 9;   /* number of outgoing edges (0..256) */
+    unsigned int weight;          /* frequency of the word ending here (if EndOfWord) */
+    char *letters;                /* sorted distinct edge labels [0..count-1] */
     NonLeafPtr *ptrs;             /* parallel children array */
+    unsigned int maxWeight;       /* largest weight of any word at or below this node */
 };
 
 /* Leaf node: whole remaining suffix (path compression) */
 struct LeafNode {
     unsigned int kind : 1;        /* == leaf */
+    unsigned int weight;          /* frequency of the word ending in this leaf */
     char *word;                   /* remaining suffix; "" is allowed */
 };
 
@@ -59,9 +64,48 @@ typedef struct {
     int   cap;
 } SuggestBox;
 
+/* Reusable, caller-owned suggestion output: the words are stored back to
+ * back (NUL-terminated) in one buffer and addressed by offset, with a
+ * small hash set for de-duplication. The buffers grow on demand and are
+ * kept between searches, so once they reach their working size a search
+ * does no heap allocation. Start with SuggestResultInit; every search
+ * replaces the previous contents. Read words with SuggestResultWord. */
+typedef struct {
+    char   *buf;                  /* words, each NUL-terminated */
+    size_t  used;                 /* bytes of buf in use */
+    size_t  bufCap;
+    size_t *offsets;              /* offsets[i]: start of word i in buf */
+    int     count;                /* words held */
+    int     cap;                  /* maxSuggestions of the last search */
+    int     offsetsCap;
+    unsigned int *slots;          /* hash set: word index + 1, 0 = empty */
+    unsigned int  slotMask;       /* slot count - 1 (power of two) */
+    int     truncated;            /* search stopped by its budget (SuggestOptions) */
+} SuggestResult;
+
+/* Limits and pre-filters for SuggestCorrectionsWithOptions. Fill with
+ * SuggestOptionsInit, then set the limits that apply. */
+typedef struct {
+    size_t maxNodes;              /* trie nodes the search may enter; 0 = no limit */
+    unsigned long long deadlineNs;/* stop once TrieNowNs() reaches this; 0 = none */
+    int    prefilter;             /* reject impossible words before the walk */
+    size_t minLen, maxLen;        /* shortest / longest dictionary word */
+    unsigned char alphabet[32];   /* bit set of the bytes used by dictionary words */
+} SuggestOptions;
+
 /* -------------------------
  * Public API
- * ------------------------- */
+ * -------------------------
+ *
+ * Thread safety: once a trie is built, every read-only entry point
+ * (SearchTrie, SearchTrieFolded, SuggestCorrections*, the SpellCheck*
+ * functions and all *Frozen / *Packed lookups) only reads shared trie
+ * memory and keeps its state in locals or caller-owned outputs, so any
+ * number of threads may call them concurrently on the same trie. Writers
+ * (TrieInsert*, TrieDestroy) need exclusive access; to add words while
+ * readers keep running, use a LiveTrie. A SuggestCache locks internally
+ * and may be shared as well.
+ */
 
 /* Uppercase in-place (ASCII), returns s; mirrored original strupr behavior. */
 char *strupr_local(char *s);
@@ -70,9 +114,14 @@ char *strupr_local(char *s);
 void Error(char *s);
 
 /* Create a fresh trie and seed it with the FIRST already UPPERCASED word.
- * Returns the root (non-leaf). */
+ * Returns the root (non-leaf). The root is embedded in an arena that owns
+ * every node, edge array and leaf suffix of this trie. */
 NonLeafPtr TrieCreateWithFirstWord(const char *upper_word);
 
+/* Release the whole trie (its arena) in one step; `root` must come from
+ * TrieCreateWithFirstWord. No node of the trie may be used afterwards. */
+void TrieDestroy(NonLeafPtr root);
+
 /* Insert an UPPERCASED word into the trie rooted at `root`.
  * Handles splitting of leaves; keeps structure minimal:
  * - in prefix cases, marks EndOfWord on the CURRENT node,
@@ -80,21 +129,458 @@ NonLeafPtr TrieCreateWithFirstWord(const char *upper_word);
  *   and frees the disconnected old leaf. */
 void TrieInsert(char *word, NonLeafPtr root);
 
+/* Remove an UPPERCASED word; returns success, or notFound if it is not in
+ * the dictionary. Nodes left redundant collapse back into path-compressed
+ * leaves and edge arrays shrink, so the trie has the same shape as one
+ * built from the remaining words, and freed memory is reused by later
+ * inserts. Removing every word leaves an empty but valid trie. Like
+ * TrieInsert, needs exclusive access (not for a LiveTrie's root). */
+int TrieRemove(NonLeafPtr root, const char *word);
+
+/* TrieInsert that also adds `weight` (a frequency/count, saturating) to
+ * the word's weight and raises the cached maximum weight of every node on
+ * its path. Words inserted by TrieInsert or the bulk builder weigh 0. */
+void TrieInsertWeighted(char *word, unsigned int weight, NonLeafPtr root);
+
+/* Weight of an UPPERCASED word, or 0 if it is not in the dictionary. */
+unsigned int TrieWordWeight(NonLeafPtr root, const char *word);
+
+/* Build a weighted trie from a text dictionary with one `word<TAB>count`
+ * entry per line (the count may be omitted: weight 0). Words are
+ * uppercased; repeated words add up their counts; words longer than 255
+ * bytes are skipped (as main.c's `%255s` would cut them). Returns NULL if
+ * the file cannot be read or holds no words. Release with TrieDestroy. */
+NonLeafPtr TrieLoadWeighted(const char *path);
+
+/* Live dictionary: words can be added while other threads keep reading.
+ * The writer never changes a node that readers can reach. It builds the
+ * changed node (or split-off subtree) privately and publishes it with a
+ * single pointer store, and frees what it replaced only after every
+ * reader that might still see it has finished (epoch-based reclamation).
+ *
+ * Reader threads join once, then bracket each unit of work:
+ *     NonLeafPtr r = LiveTrieReadBegin(reader);
+ *     SearchTrie(r, w); SuggestCorrections(r, w, 10, &box); ...
+ *     LiveTrieReadEnd(reader);
+ * Any read-only entry point may be used on `r` (SearchTrie*, Suggest*,
+ * SpellCheck*, TrieFreeze, DeleteIndexBuild, ...), but not TrieInsert*,
+ * TrieDestroy or TrieGetStats, and only between Begin and End. Readers
+ * never wait; an open section only delays freeing the replaced memory
+ * (and the occasional insert that waits to free it). */
+typedef struct LiveTrie LiveTrie;
+typedef struct LiveReader LiveReader;
+
+/* Take over a built trie (from TrieCreateWithFirstWord, TrieBuildFromSorted
+ * or TrieLoadWeighted); from now on it is only reached through `lt`. */
+LiveTrie *LiveTrieCreate(NonLeafPtr root);
+
+/* Release the trie. No reader may be joined any more. */
+void LiveTrieDestroy(LiveTrie *lt);
+
+/* Add an UPPERCASED word (weight 0). Callable from any thread; writers are
+ * serialized, readers are never blocked. The word is visible to read
+ * sections that begin after the call returns. */
+void LiveTrieInsert(LiveTrie *lt, const char *upper_word);
+
+/* Wait until no reader can hold replaced nodes and free them now (inserts
+ * do this on their own every few hundred replacements). */
+void LiveTrieSynchronize(LiveTrie *lt);
+
+/* Register / unregister the calling thread as a reader. */
+LiveReader *LiveTrieReaderJoin(LiveTrie *lt);
+void LiveTrieReaderLeave(LiveReader *r);
+
+/* Enter a read section and return the current root; leave it. */
+NonLeafPtr LiveTrieReadBegin(LiveReader *r);
+void LiveTrieReadEnd(LiveReader *r);
+
+/* Input check for the bulk builder (TrieCheckSorted results). */
+enum {
+    bulkOk = 0,        /* strictly increasing, non-empty words */
+    bulkEmptyInput,    /* n == 0 */
+    bulkEmptyWord,     /* NULL or "" entry */
+    bulkUnsorted,      /* words[i-1] > words[i] */
+    bulkDuplicate      /* words[i-1] == words[i] */
+};
+
+/* Validate that `words` are non-empty and strictly increasing in trie
+ * order (byte-wise `char` comparison, a prefix before its extensions;
+ * identical to strcmp / `LC_ALL=C sort` for ASCII). Returns bulkOk or the
+ * first violation, with its index stored in *badIndex (if non-NULL).
+ * Case is not checked: as for TrieInsert, the caller passes UPPERCASED
+ * words, or SearchTrie on uppercased input will not find them. */
+int TrieCheckSorted(const char **words, size_t n, size_t *badIndex);
+
+/* Build a trie from a sorted word list in one linear pass: every node is
+ * created once at its final size (no leaf splits, no edge regrowth). The
+ * result is identical to TrieCreateWithFirstWord + TrieInsert over the same
+ * words. Returns NULL if TrieCheckSorted rejects the input (the offending
+ * index goes to *badIndex). Release with TrieDestroy. */
+NonLeafPtr TrieBuildFromSorted(const char **words, size_t n, size_t *badIndex);
+
+/* Build a trie from UPPERCASED words in any order (duplicates allowed) on
+ * `threads` threads (<= 0: one per CPU). The words are sharded by first
+ * byte and each shard's subtrie is built by one thread in an arena of its
+ * own; the root is then assembled in one step. The result is identical to
+ * TrieCreateWithFirstWord + TrieInsert over the same words. Returns NULL
+ * if n == 0. Release with TrieDestroy. */
+NonLeafPtr TrieBuildParallel(const char **words, size_t n, int threads);
+
 /* Exact search: returns success (1) if in dictionary; 0 otherwise. */
 int SearchTrie(NonLeafPtr root, char *word);
 
+/* Exact search of `n` UPPERCASED words at once: results[i] receives
+ * SearchTrie(root, words[i]). Up to 16 lookups are kept in flight and
+ * advanced round-robin, one node per turn, prefetching what each will read
+ * next, so their cache misses overlap instead of being paid one by one.
+ * Worth it for many words against a trie larger than the CPU caches. */
+void SearchTrieBatch(NonLeafPtr root, const char *const *words, size_t n, int *results);
+
+/* Exact search on a length-delimited word (no NUL needed) whose ASCII
+ * letters may be in either case; a-z are folded to A-Z on the fly, so the
+ * input is neither copied nor modified. */
+int SearchTrieFolded(NonLeafPtr root, const char *word, size_t len);
+
 /* Side-view printer for debugging. */
 void TrieSideView(int depth, NonLeafPtr p, char *prefix);
 
+/* Shape and memory of a trie (TrieGetStats). */
+#define TRIE_STATS_DEPTHS 64      /* depth histogram buckets; the last one is "deeper" */
+
+typedef struct {
+    size_t nonLeaves;             /* non-leaf nodes, root included */
+    size_t leaves;
+    size_t edges;                 /* parent -> child links */
+    size_t words;                 /* leaves + EndOfWord non-leaves */
+    size_t maxDepth;              /* longest edge path from the root */
+    size_t suffixBytes;           /* leaf suffix bytes, NULs included */
+    size_t fanout[257];           /* fanout[n]: non-leaves with n edges */
+    size_t wordDepth[TRIE_STATS_DEPTHS]; /* words resolved after d edges
+                                             (the nodes a lookup visits) */
+    size_t nodeHeapBytes;         /* heap reserved by the node slab */
+    size_t edgeHeapBytes;         /* ... by the edge block slab */
+    size_t suffixHeapBytes;       /* ... by the suffix slab */
+    size_t heapBytes;             /* all slabs + the arena record (chunk headers
+                                     included, malloc's own overhead not) */
+} TrieStats;
+
+/* Walk the trie and fill *out. Read-only, O(nodes). */
+void TrieGetStats(NonLeafPtr root, TrieStats *out);
+
+/* Hot-path counters, compiled in only when the library is built with
+ * TRIE_COUNTERS=1 (CMake option TRIE_COUNTERS); otherwise the paths carry
+ * no extra code and the counters stay zero. Counters are per thread: reset,
+ * run the call of interest, read. */
+typedef struct {
+    unsigned long long searches;       /* SearchTrie calls */
+    unsigned long long searchNodes;    /* nodes visited by SearchTrie */
+    unsigned long long suggests;       /* SuggestCorrections(Into) calls */
+    unsigned long long suggestNodes;   /* non-leaves entered by the suggestion DFS */
+    unsigned long long tailCompares;   /* leaf tail comparisons (both paths) */
+    unsigned long long editsExplored;  /* branches that spend the edit */
+    unsigned long long cutoffs;        /* edges skipped: edit spent, letter differs */
+} TrieCounters;
+
+/* Copy the calling thread's counters; returns 1 if counters are compiled
+ * in, 0 if not (then *out is all zero). */
+int  TrieCountersGet(TrieCounters *out);
+
+/* Zero the calling thread's counters. */
+void TrieCountersReset(void);
+
 /* Suggestions (Damerau-Levenshtein distance <= 1).
  * Produces up to `maxSuggestions` dictionary words close to `upper_word`.
  * Owns memory inside SuggestBox; free with FreeSuggestBox. */
 void SuggestCorrections(NonLeafPtr root, const char *upper_word,
                         int maxSuggestions, SuggestBox *outBox);
 
+/* Ranked variant of SuggestCorrections (same one-edit candidates): every
+ * candidate is scored by its edit type (exact > transposition >
+ * insertion/deletion > substitution) times its weight + 1, and the
+ * `maxSuggestions` best are returned, best first (ties in discovery
+ * order). Subtrees whose cached maximum weight cannot beat the current
+ * k-th best score are skipped. Owns memory inside SuggestBox. */
+void SuggestCorrectionsRanked(NonLeafPtr root, const char *upper_word,
+                              int maxSuggestions, SuggestBox *outBox);
+
+/* Suggestions within Damerau-Levenshtein (optimal string alignment)
+ * distance `k` of `upper_word`: the trie is walked once carrying a DP row
+ * per level, pruning every subtree whose row minimum exceeds the bound.
+ * Returns the `maxSuggestions` closest words, nearest first (ties in trie
+ * order). Words longer than 255 - k chars get no suggestions. Owns memory
+ * inside SuggestBox; free with FreeSuggestBox. */
+void SuggestCorrectionsK(NonLeafPtr root, const char *upper_word, int k,
+                         int maxSuggestions, SuggestBox *outBox);
+
+/* Optional deletion-neighbourhood index (symmetric delete, as in
+ * SymSpell): trades memory for suggestion latency. Built from the words of
+ * a trie; independent of it afterwards and safe to share between threads. */
+typedef struct DeleteIndex DeleteIndex;
+
+/* Index every word of the trie for queries up to `maxDistance` (>= 1;
+ * 1 or 2 are practical) edits. Only the first `prefixLength` chars of a
+ * word produce delete variants (<= 0: the whole word). Candidates are
+ * verified on the full words, and two words within k edits have prefixes
+ * that are within k deletes of a common string, so a prefix drops no
+ * suggestion for k <= maxDistance (tests/test_delete_index.c checks this
+ * against SuggestCorrectionsK). A short prefix costs query time instead:
+ * at prefixLength <= k every word of similar length is a candidate. 7 is
+ * a common choice that bounds memory at little query cost. */
+DeleteIndex *DeleteIndexBuild(NonLeafPtr root, int maxDistance, int prefixLength);
+
+/* Release the index. */
+void DeleteIndexDestroy(DeleteIndex *ix);
+
+/* Heap bytes held by the index. */
+size_t DeleteIndexBytes(const DeleteIndex *ix);
+
+/* Same words and order as SuggestCorrectionsK (nearest first, ties in trie
+ * order) for k <= the index's maxDistance (larger k is clamped). */
+void SuggestCorrectionsIndexed(const DeleteIndex *ix, const char *upper_word, int k,
+                               int maxSuggestions, SuggestBox *outBox);
+
 /* Free all strings inside SuggestBox and the array itself. */
 void FreeSuggestBox(SuggestBox *box);
 
+/* SuggestCorrections writing into a reusable SuggestResult instead of a
+ * freshly allocated SuggestBox; same words in the same order. */
+void SuggestCorrectionsInto(NonLeafPtr root, const char *upper_word,
+                            int maxSuggestions, SuggestResult *out);
+
+/* SuggestCorrectionsInto for `count` words at once: one walk of the trie
+ * advances all of them, so the upper levels are visited once per batch
+ * instead of once per word. outs[i] (each initialized with
+ * SuggestResultInit) receives the same words, in the same order, as
+ * SuggestCorrectionsInto(root, upper_words[i], ...). */
+void SuggestCorrectionsBatch(NonLeafPtr root, const char *const *upper_words, size_t count,
+                             int maxSuggestions, SuggestResult *outs);
+
+/* SuggestCorrectionsInto with bounded work, for latency-sensitive callers:
+ * the search stops after `opts->maxNodes` trie nodes or at the deadline
+ * (checked every few dozen nodes) and sets out->truncated; the words found
+ * until then are kept, in the usual order. With `opts->prefilter`, words
+ * that no dictionary word is within one edit of by length (outside
+ * minLen - 1 .. maxLen + 1) or by alphabet (two or more bytes no word
+ * uses) return empty without a walk. opts == NULL means no limits. */
+void SuggestCorrectionsWithOptions(NonLeafPtr root, const char *upper_word, int maxSuggestions,
+                                   const SuggestOptions *opts, SuggestResult *out);
+
+/* No limits, with pre-filters built from the words of `root` (one walk of
+ * the trie; rebuild after changing the dictionary). root == NULL: no
+ * pre-filters. */
+void SuggestOptionsInit(SuggestOptions *opts, NonLeafPtr root);
+
+/* Monotonic clock in nanoseconds, for SuggestOptions.deadlineNs. */
+unsigned long long TrieNowNs(void);
+
+/* Empty result with no buffers yet. */
+void SuggestResultInit(SuggestResult *r);
+
+/* Release the buffers of a result (it is left empty and reusable). */
+void SuggestResultFree(SuggestResult *r);
+
+/* Word `i` (0 <= i < r->count) of a result; valid until the next search. */
+static inline const char *SuggestResultWord(const SuggestResult *r, int i) {
+    return r->buf + r->offsets[i];
+}
+
+/* Prefix completion: the `k` heaviest words starting with `prefix`
+ * (UPPERCASED; "" completes the whole dictionary), heaviest first, equal
+ * weights in alphabetical order. Explores best-first by the cached
+ * maximum weights, so the cost depends on k, not on how many words share
+ * the prefix. Writes into `out` (replacing its contents); no heap
+ * allocation once `out` has reached its working size. */
+void TrieComplete(NonLeafPtr root, const char *prefix, int k, SuggestResult *out);
+
+/* -------------------------
+ * Suggestion cache
+ * ------------------------- */
+
+/* Bounded LRU cache of suggestion results for one trie. Real text repeats
+ * the same typos, so a misspelled token's "not in dictionary" answer and
+ * its suggestion list are kept under the uppercased token and reused.
+ * Correctly spelled words are not cached (SearchTrie is cheaper than a
+ * cache entry). The cache is sharded with one lock per shard, so it may be
+ * shared by any number of threads. */
+typedef struct SuggestCache SuggestCache;
+
+typedef struct {
+    unsigned long long hits;      /* lookups answered from the cache */
+    unsigned long long misses;    /* lookups that went to the trie */
+    unsigned long long evictions; /* entries dropped to stay under the cap */
+    size_t entries;               /* entries currently held */
+    size_t bytes;                 /* memory held, including hash tables */
+    size_t maxBytes;              /* configured cap */
+} SuggestCacheStats;
+
+/* Create a cache answering for the trie at `root`, holding at most about
+ * `maxBytes` (split evenly across the shards). Aborts on OOM. */
+SuggestCache *SuggestCacheCreate(NonLeafPtr root, size_t maxBytes);
+
+/* Release the cache; the trie is not touched. */
+void SuggestCacheDestroy(SuggestCache *cache);
+
+/* Drop every entry (e.g. after words were inserted); counters are kept. */
+void SuggestCacheClear(SuggestCache *cache);
+
+/* Check the token word[0..len) (ASCII letters folded to uppercase).
+ * Returns success if it is in the dictionary, leaving `outBox` empty;
+ * otherwise returns 0 and fills `outBox` with the same list
+ * SuggestCorrections would produce, from the cache when possible.
+ * `outBox` is always initialized; free it with FreeSuggestBox. */
+int SuggestCached(SuggestCache *cache, const char *word, size_t len,
+                  int maxSuggestions, SuggestBox *outBox);
+
+/* Snapshot of the counters summed over all shards. */
+void SuggestCacheGetStats(SuggestCache *cache, SuggestCacheStats *out);
+
+/* -------------------------
+ * Buffer / file checking
+ * ------------------------- */
+
+/* One misspelled token of the checked input. */
+typedef struct {
+    size_t offset;                /* byte offset of the token in the input */
+    size_t length;                /* token length in bytes */
+    size_t line;                  /* 1-based line number */
+    SuggestBox suggestions;       /* filled only when suggestions were requested */
+} Misspelling;
+
+/* Growable list of misspellings; start from a zeroed list. */
+typedef struct {
+    Misspelling *items;
+    size_t count;
+    size_t cap;
+} MisspellingList;
+
+/* Check every token of buf[0..len) and append a record for each token not
+ * in the dictionary. A token is a maximal run of letters: ASCII letters
+ * and, in valid UTF-8, letters of the common alphabetic scripts; other
+ * bytes separate tokens. Tokens are folded to uppercase (ASCII) during
+ * lookup, so `buf` may be read-only (e.g. mmap'd) and is never copied.
+ * Returns the number of records appended. */
+size_t SpellCheckBuffer(NonLeafPtr root, const char *buf, size_t len,
+                        MisspellingList *out);
+
+/* Parallel SpellCheckBuffer: the buffer is cut into chunks at token
+ * boundaries, `threads` workers (<= 0: one per CPU) check chunks against
+ * the shared trie and, if maxSuggestions > 0, fill each record's
+ * `suggestions` with what SuggestCorrections returns (batched per chunk
+ * with SuggestCorrectionsBatch), or through `cache` if non-NULL
+ * (it must have been created for `root`). Records are merged in input
+ * order with global line numbers, so the result is identical for any
+ * thread count. Returns the number of records appended. */
+size_t SpellCheckBufferParallel(NonLeafPtr root, const char *buf, size_t len,
+                                int threads, int maxSuggestions,
+                                SuggestCache *cache, MisspellingList *out);
+
+/* Same for a file, read in large blocks; offsets are file offsets.
+ * Returns success, or 0 if the file cannot be opened or read. */
+int SpellCheckFile(NonLeafPtr root, const char *path, MisspellingList *out);
+
+/* Tokenizer implementations (SpellCheckScanner). */
+enum {
+    scanAuto = 0,                 /* best the CPU supports (default) */
+    scanScalar,
+    scanSSE2,
+    scanAVX2
+};
+
+/* Choose the tokenizer used by the SpellCheck* functions; a level the CPU
+ * or build lacks falls back to the best available one. All levels give
+ * identical results. Returns the level now in effect. */
+int SpellCheckScanner(int level);
+
+/* Free the records (and their suggestions) of a list and reset it. */
+void FreeMisspellingList(MisspellingList *list);
+
+/* -------------------------
+ * Packed trie
+ * ------------------------- */
+
+/* Memory-lean radix trie that still takes inserts: each node is one
+ * variable-length record (header, inline edge labels, 32-bit child
+ * indices) in a single pool, chains of single-edge nodes fold into a
+ * prefix string of the record below them, and leaf suffixes are stored
+ * inline. About a third of the pointer trie's footprint for the same
+ * words. Like TrieInsert, inserts need exclusive access. */
+typedef struct PackedTrie PackedTrie;
+
+/* Empty packed trie. */
+PackedTrie *PackedTrieCreate(void);
+
+/* Release a packed trie. */
+void PackedTrieDestroy(PackedTrie *pt);
+
+/* Insert an UPPERCASED word (no-op if present). */
+void PackedTrieInsert(PackedTrie *pt, const char *upper_word);
+
+/* SearchTrie equivalent: success (1) if `word` is in the dictionary. */
+int SearchPacked(const PackedTrie *pt, const char *word);
+
+/* SuggestCorrections equivalent; returns the same list in the same order. */
+void SuggestCorrectionsPacked(const PackedTrie *pt, const char *upper_word,
+                              int maxSuggestions, SuggestBox *outBox);
+
+/* SuggestCorrectionsInto equivalent (allocation-free in steady state). */
+void SuggestCorrectionsPackedInto(const PackedTrie *pt, const char *upper_word,
+                                  int maxSuggestions, SuggestResult *out);
+
+/* Heap bytes held by the packed trie (pool capacity included). */
+size_t PackedTrieBytes(const PackedTrie *pt);
+
+/* Give the pool's growth reserve back, e.g. once loading is done. Later
+ * inserts grow it again. */
+void PackedTrieTrim(PackedTrie *pt);
+
+/* -------------------------
+ * Frozen (read-only) trie
+ * ------------------------- */
+
+/* Flat, read-only copy of a built trie: one contiguous block holding
+ * breadth-first node records with inline edge labels, 32-bit child
+ * offsets and a pooled suffix blob. Safe to share between threads. */
+typedef struct FrozenTrie FrozenTrie;
+
+/* Flatten the trie rooted at `root`. The source is not modified and may be
+ * destroyed (TrieDestroy) afterwards; the frozen copy is independent. */
+FrozenTrie *TrieFreeze(NonLeafPtr root);
+
+/* Release a frozen trie. */
+void FrozenTrieDestroy(FrozenTrie *ft);
+
+/* Total size of the frozen representation in bytes. */
+size_t FrozenTrieBytes(const FrozenTrie *ft);
+
+/* SearchTrie equivalent: success (1) if `word` is in the dictionary. */
+int SearchFrozen(const FrozenTrie *ft, const char *word);
+
+/* SuggestCorrections equivalent; returns the same list in the same order. */
+void SuggestCorrectionsFrozen(const FrozenTrie *ft, const char *upper_word,
+                              int maxSuggestions, SuggestBox *outBox);
+
+/* SuggestCorrectionsInto equivalent (allocation-free in steady state). */
+void SuggestCorrectionsFrozenInto(const FrozenTrie *ft, const char *upper_word,
+                                  int maxSuggestions, SuggestResult *out);
+
+/* -------------------------
+ * Binary dictionary files
+ * ------------------------- */
+
+/* Write the frozen form of a trie to `path` (versioned, position-independent
+ * format; replaced atomically via `<path>.tmp`). Returns success or 0. */
+int TrieSave(NonLeafPtr root, const char *path);
+
+/* Same, for an already frozen (or mapped) trie. */
+int FrozenTrieSave(const FrozenTrie *ft, const char *path);
+
+/* Map a file written by TrieSave read-only and query it in place: no
+ * parsing or copying, and the pages are shared between processes.
+ * Returns NULL if the file is missing or not a valid dictionary of this
+ * version and byte order; release with FrozenTrieDestroy. Only the header
+ * and total size are checked, so the file must come from TrieSave. */
+FrozenTrie *TrieOpenMapped(const char *path);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,327 @@
+#include "TrieNode.h"
+#include "TrieSuggest.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ================================================================ *
+ * Deletion-neighbourhood index (symmetric delete, SymSpell-style)  *
+ *                                                                  *
+ * Two words are within d edits only if deleting at most d chars    *
+ * from each makes them equal. The index stores, for every delete   *
+ * variant of every dictionary word, the ids of the words that      *
+ * produce it; a query generates its own delete variants, unions    *
+ * the candidate lists and verifies each candidate with a bounded   *
+ * Damerau (OSA) distance. No trie walk and no edit branching.      *
+ *                                                                  *
+ * Layout (all flat arrays):                                        *
+ *  - pool/wordOff: the words, NUL-terminated, in trie order (id),  *
+ *  - slots: open-addressing table keyed by the 32-bit FNV-1a hash  *
+ *           of a variant -> [start, start + count) in `ids`,       *
+ *  - ids:   candidate word ids, ascending within each list.        *
+ * Hash collisions only add candidates, which verification drops.   *
+ *                                                                  *
+ * Like SymSpell, variants can be limited to the first              *
+ * `prefixLength` chars of each word (and of the query), which      *
+ * bounds the variants per word and keeps memory in check; full     *
+ * words are still verified.                                        *
+ * ================================================================ */
+
+typedef struct {
+    uint32_t hash;
+    uint32_t start;               /* first id in `ids` */
+    uint32_t count;               /* 0 => empty slot */
+} IndexSlot;
+
+struct DeleteIndex {
+    int maxDistance;
+    int prefixLength;             /* 0 => whole words */
+    char *pool;                   /* words, NUL-terminated */
+    size_t poolBytes, poolCap;
+    uint32_t *wordOff;            /* word id -> offset in pool (+1 sentinel) */
+    uint32_t nWords, wordCap;
+    IndexSlot *slots;
+    uint32_t slotMask;
+    uint32_t nKeys;
+    uint32_t *ids;
+    size_t nIds;
+};
+
+/* Growable scratch list of 32-bit values. */
+typedef struct {
+    uint32_t *v;
+    size_t n, cap;
+} U32List;
+
+static void U32Push(U32List *l, uint32_t x) {
+    if (l->n == l->cap) {
+        size_t cap = l->cap ? l->cap * 2 : 256;
+        uint32_t *v = (uint32_t*)realloc(l->v, cap * sizeof(uint32_t));
+        if (!v) Error("out of memory: DeleteIndex");
+        l->v = v;
+        l->cap = cap;
+    }
+    l->v[l->n++] = x;
+}
+
+static int CompareU32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t*)a, y = *(const uint32_t*)b;
+    return x < y ? -1 : x > y;
+}
+
+static void SortUnique(U32List *l) {
+    if (l->n < 2) return;
+    qsort(l->v, l->n, sizeof(uint32_t), CompareU32);
+    size_t u = 1;
+    for (size_t i = 1; i < l->n; ++i)
+        if (l->v[i] != l->v[u - 1]) l->v[u++] = l->v[i];
+    l->n = u;
+}
+
+static uint32_t HashBytes(const char *s, int n) {
+    uint32_t h = 2166136261u;
+    for (int i = 0; i < n; ++i) {
+        h ^= (unsigned char)s[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+/* Hashes of every string made by deleting up to `left` chars of s[0..n)
+ * at positions >= from (each deletion set is produced once). */
+static void Deletes(char *s, int n, int from, int left, U32List *out) {
+    U32Push(out, HashBytes(s, n));
+    if (left == 0) return;
+    for (int i = from; i < n; ++i) {
+        char ch = s[i];
+        memmove(s + i, s + i + 1, (size_t)(n - i - 1));
+        Deletes(s, n - 1, i, left - 1, out);
+        memmove(s + i + 1, s + i, (size_t)(n - i - 1));
+        s[i] = ch;
+    }
+}
+
+/* Unique variant hashes of `word` (its first prefixLength chars). */
+static void Variants(const DeleteIndex *ix, const char *word, int d, U32List *out) {
+    char buf[256];
+    int n = (int)strlen(word);
+    if (ix->prefixLength > 0 && n > ix->prefixLength) n = ix->prefixLength;
+    if (n > (int)sizeof(buf)) n = (int)sizeof(buf);
+    memcpy(buf, word, (size_t)n);
+
+    out->n = 0;
+    Deletes(buf, n, 0, d, out);
+    SortUnique(out);
+}
+
+/* ========================= *
+ * Build                     *
+ * ========================= */
+
+static void AddWord(DeleteIndex *ix, const char *prefix, size_t plen, const char *tail) {
+    size_t lt = strlen(tail), need = plen + lt + 1;
+    if (ix->poolBytes + need > ix->poolCap) {
+        size_t cap = ix->poolCap ? ix->poolCap * 2 : 1u << 16;
+        while (cap < ix->poolBytes + need) cap *= 2;
+        char *p = (char*)realloc(ix->pool, cap);
+        if (!p) Error("out of memory: DeleteIndex");
+        ix->pool = p;
+        ix->poolCap = cap;
+    }
+    if (ix->nWords + 1 >= ix->wordCap) {
+        uint32_t cap = ix->wordCap ? ix->wordCap * 2 : 1024;
+        uint32_t *o = (uint32_t*)realloc(ix->wordOff, cap * sizeof(uint32_t));
+        if (!o) Error("out of memory: DeleteIndex");
+        ix->wordOff = o;
+        ix->wordCap = cap;
+    }
+    ix->wordOff[ix->nWords++] = (uint32_t)ix->poolBytes;
+    memcpy(ix->pool + ix->poolBytes, prefix, plen);
+    memcpy(ix->pool + ix->poolBytes + plen, tail, lt + 1);
+    ix->poolBytes += need;
+}
+
+/* Collect the words of the trie in trie order; `prefix` grows as needed. */
+static void CollectWords(DeleteIndex *ix, NonLeafPtr p, char **prefix, size_t *cap, size_t depth) {
+    if (p->EndOfWord == yes) AddWord(ix, *prefix, depth, "");
+    if (depth + 1 >= *cap) {
+        char *b = (char*)realloc(*prefix, *cap * 2);
+        if (!b) Error("out of memory: DeleteIndex");
+        *prefix = b;
+        *cap *= 2;
+    }
+    for (int i = 0; i < (int)p->count; ++i) {
+        NonLeafPtr child = p->ptrs[i];
+        (*prefix)[depth] = p->letters[i];
+        if (child->kind == leaf)
+            AddWord(ix, *prefix, depth + 1, ((LeafPtr)child)->word);
+        else
+            CollectWords(ix, child, prefix, cap, depth + 1);
+    }
+}
+
+static IndexSlot *FindSlot(IndexSlot *slots, uint32_t mask, uint32_t hash) {
+    uint32_t i = hash & mask;
+    while (slots[i].count && slots[i].hash != hash) i = (i + 1) & mask;
+    return &slots[i];
+}
+
+static void GrowSlots(DeleteIndex *ix) {
+    uint32_t n = ix->slots ? (ix->slotMask + 1) * 2 : 1u << 16;
+    IndexSlot *t = (IndexSlot*)calloc(n, sizeof(IndexSlot));
+    if (!t) Error("out of memory: DeleteIndex");
+    if (ix->slots)
+        for (uint32_t i = 0; i <= ix->slotMask; ++i)
+            if (ix->slots[i].count) *FindSlot(t, n - 1, ix->slots[i].hash) = ix->slots[i];
+    free(ix->slots);
+    ix->slots = t;
+    ix->slotMask = n - 1;
+}
+
+DeleteIndex *DeleteIndexBuild(NonLeafPtr root, int maxDistance, int prefixLength) {
+    DeleteIndex *ix = (DeleteIndex*)calloc(1, sizeof(DeleteIndex));
+    if (!ix) Error("out of memory: DeleteIndexBuild");
+    ix->maxDistance = maxDistance < 1 ? 1 : maxDistance;
+    ix->prefixLength = prefixLength > 0 ? prefixLength : 0;
+
+    size_t cap = 256;
+    char *prefix = (char*)malloc(cap);
+    if (!prefix) Error("out of memory: DeleteIndexBuild");
+    CollectWords(ix, root, &prefix, &cap, 0);
+    free(prefix);
+    ix->wordOff[ix->nWords] = (uint32_t)ix->poolBytes;    /* sentinel */
+
+    /* pass 1: count the words behind every variant */
+    U32List vars = { NULL, 0, 0 };
+    GrowSlots(ix);
+    for (uint32_t w = 0; w < ix->nWords; ++w) {
+        Variants(ix, ix->pool + ix->wordOff[w], ix->maxDistance, &vars);
+        for (size_t v = 0; v < vars.n; ++v) {
+            if ((ix->nKeys + 1) * 10u > (ix->slotMask + 1) * 7u) GrowSlots(ix);
+            IndexSlot *s = FindSlot(ix->slots, ix->slotMask, vars.v[v]);
+            if (!s->count) {
+                s->hash = vars.v[v];
+                ix->nKeys++;
+            }
+            s->count++;
+            ix->nIds++;
+        }
+    }
+
+    /* lay the lists out back to back; `start` points past each list */
+    ix->ids = (uint32_t*)malloc((ix->nIds ? ix->nIds : 1) * sizeof(uint32_t));
+    if (!ix->ids) Error("out of memory: DeleteIndexBuild");
+    uint32_t end = 0;
+    for (uint32_t i = 0; i <= ix->slotMask; ++i)
+        if (ix->slots[i].count) {
+            end += ix->slots[i].count;
+            ix->slots[i].start = end;
+        }
+
+    /* pass 2: fill each list from the back, last word first, so the ids
+       ascend and `start` ends up at the first one */
+    for (uint32_t w = ix->nWords; w-- > 0;) {
+        Variants(ix, ix->pool + ix->wordOff[w], ix->maxDistance, &vars);
+        for (size_t v = 0; v < vars.n; ++v)
+            ix->ids[--FindSlot(ix->slots, ix->slotMask, vars.v[v])->start] = w;
+    }
+    free(vars.v);
+    return ix;
+}
+
+void DeleteIndexDestroy(DeleteIndex *ix) {
+    if (!ix) return;
+    free(ix->pool);
+    free(ix->wordOff);
+    free(ix->slots);
+    free(ix->ids);
+    free(ix);
+}
+
+size_t DeleteIndexBytes(const DeleteIndex *ix) {
+    return sizeof(*ix) + ix->poolCap + (size_t)ix->wordCap * sizeof(uint32_t) +
+           ((size_t)ix->slotMask + 1) * sizeof(IndexSlot) + ix->nIds * sizeof(uint32_t);
+}
+
+/* ========================= *
+ * Query                     *
+ * ========================= */
+
+/* Damerau (OSA) distance of a and b if <= k, else k + 1. For k == 1 this
+ * is the trie's tail matcher applied to whole words. */
+static int BoundedDistance(const char *a, const char *b, int k) {
+    if (k <= 1) {
+        int kind = TailEditKind(a, b, 0);
+        return kind == notFound ? 2 : kind != editNone;
+    }
+
+    int la = (int)strlen(a), lb = (int)strlen(b);
+    if (la - lb > k || lb - la > k) return k + 1;
+
+    int small[3 * 64];
+    int *rows = lb < 64 ? small : (int*)malloc(3 * (size_t)(lb + 1) * sizeof(int));
+    if (!rows) Error("out of memory: DeleteIndex");
+    int *r2 = rows, *r1 = rows + (lb + 1), *r0 = rows + 2 * (lb + 1);
+
+    for (int j = 0; j <= lb; ++j) r1[j] = j;
+    for (int i = 1; i <= la; ++i) {
+        int best = r0[0] = i;
+        for (int j = 1; j <= lb; ++j) {
+            int v = r1[j - 1] + (a[i - 1] != b[j - 1]);
+            if (r1[j] + 1 < v) v = r1[j] + 1;
+            if (r0[j - 1] + 1 < v) v = r0[j - 1] + 1;
+            if (i > 1 && j > 1 && a[i - 1] == b[j - 2] && a[i - 2] == b[j - 1] && r2[j - 2] + 1 < v)
+                v = r2[j - 2] + 1;
+            r0[j] = v;
+            if (v < best) best = v;
+        }
+        if (best > k) { lb = -1; break; }             /* no cell can come back under k */
+        int *t = r2; r2 = r1; r1 = r0; r0 = t;
+    }
+    int d = lb < 0 ? k + 1 : r1[lb];
+    if (rows != small) free(rows);
+    return d > k ? k + 1 : d;
+}
+
+static int CompareRanked(const void *a, const void *b) {
+    const uint32_t *x = (const uint32_t*)a, *y = (const uint32_t*)b;
+    if (x[0] != y[0]) return x[0] < y[0] ? -1 : 1;     /* distance */
+    return x[1] < y[1] ? -1 : x[1] > y[1];             /* trie order */
+}
+
+void SuggestCorrectionsIndexed(const DeleteIndex *ix, const char *upper_word, int k,
+                               int maxSuggestions, SuggestBox *outBox) {
+    if (!SuggestBoxInit(outBox, maxSuggestions)) return;
+    if (k > ix->maxDistance) k = ix->maxDistance;
+    if (k < 0 || maxSuggestions <= 0) return;
+
+    int qlen = (int)strlen(upper_word);
+    U32List vars = { NULL, 0, 0 }, cand = { NULL, 0, 0 }, hits = { NULL, 0, 0 };
+    Variants(ix, upper_word, k, &vars);
+
+    for (size_t v = 0; v < vars.n; ++v) {
+        const IndexSlot *s = FindSlot(ix->slots, ix->slotMask, vars.v[v]);
+        for (uint32_t i = 0; i < s->count; ++i) {
+            uint32_t w = ix->ids[s->start + i];
+            int len = (int)(ix->wordOff[w + 1] - ix->wordOff[w]) - 1;
+            if (len - qlen <= k && qlen - len <= k) U32Push(&cand, w);
+        }
+    }
+    SortUnique(&cand);
+
+    for (size_t c = 0; c < cand.n; ++c) {
+        int d = BoundedDistance(ix->pool + ix->wordOff[cand.v[c]], upper_word, k);
+        if (d <= k) {
+            U32Push(&hits, (uint32_t)d);
+            U32Push(&hits, cand.v[c]);
+        }
+    }
+    if (hits.n) qsort(hits.v, hits.n / 2, 2 * sizeof(uint32_t), CompareRanked);
+
+    for (size_t h = 0; h < hits.n / 2 && outBox->count < maxSuggestions; ++h)
+        SuggestBoxAdd(outBox, ix->pool + ix->wordOff[hits.v[2 * h + 1]]);
+
+    free(vars.v);
+    free(cand.v);
+    free(hits.v);
+}
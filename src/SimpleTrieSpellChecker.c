@@ -1,8 +1,10 @@
 #include "SimpleTrieSpellChecker.h"
+#include "TrieNode.h"
+#include "TrieSuggest.h"
+#include "TextScan.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <ctype.h>
 
 /* ========================= *
  * Utilities / basic helpers *
@@ -14,112 +16,111 @@ void Error(char *s) {
 }
 
 char *strupr_local(char *s) {
-    char *ss = s;
-    for (; *s; ++s) *s = (char)toupper((unsigned char)*s);
-    return ss;
-}
-
-/* Find position of `ch` in p->letters (sorted). Returns index or notFound. */
-static int Position(NonLeafPtr p, char ch) {
-    if (!p->letters) return notFound;
-    int len = (int)strlen(p->letters);
-    for (int i = 0; i < len; ++i)
-        if (p->letters[i] == ch) return i;
-    return notFound;
+    ScanUpperCopy(s, s, strlen(s));
+    return s;
 }
 
 /* ========================= *
  * Memory / node factories   *
- * ========================= */
+ * ========================= *
+ * All records come from the trie's arena (see TrieArena.h).        *
+ * letters/ptrs share one edge block whose capacity is a power of   *
+ * two, so most AddCell calls shift in place and only a full block  *
+ * moves to the next size class.                                    */
+
+/* Insert edge `ch` at index `stop`, shifting the upper part (>= stop) by +1. */
+static void AddCell(TrieArena *a, char ch, NonLeafPtr p, int stop) {
+    int len = (int)p->count;
+    int cls = EdgeClass(len + 1);
+
+    if ((len & (len - 1)) == 0) {
+        /* block is full (or absent): move to the next size class */
+        char *letters;
+        NonLeafPtr *ptrs = ArenaEdgeBlock(a, cls, &letters);
+
+        if (len > 0) {
+            memcpy(ptrs, p->ptrs, (size_t)stop * sizeof(NonLeafPtr));
+            memcpy(ptrs + stop + 1, p->ptrs + stop, (size_t)(len - stop) * sizeof(NonLeafPtr));
+            memcpy(letters, p->letters, (size_t)stop);
+            memcpy(letters + stop + 1, p->letters + stop, (size_t)(len - stop));
+            ArenaFreeEdgeBlock(a, EdgeClass(len), p->ptrs);
+        }
+        p->letters = letters;
+        p->ptrs    = ptrs;
 
-/* Expand letters/ptrs by inserting edge `ch` at index `stop`.
- * Copies both lower (<stop) and upper (>=stop) portions from old buffers. */
-static void AddCell(char ch, NonLeafPtr p, int stop) {
-    int len = !p->letters ? 0 : (int)strlen(p->letters);
-    char *old_letters = p->letters;
-    NonLeafPtr *old_ptrs = p->ptrs;
-
-    /* allocate new, bigger buffers; calloc() zeros new ptrs slots */
-    p->letters = (char*)malloc((size_t)len + 2);
-    p->ptrs    = (NonLeafPtr*)calloc((size_t)(len + 1), sizeof(NonLeafPtr));
-    if (!p->letters || !p->ptrs) Error("out of memory: AddCell");
-
-    /* shift the upper half (> stop-1) by +1 */
-    for (int i = len; i >= stop + 1; --i) {
-        p->ptrs[i]    = old_ptrs[i - 1];
-        p->letters[i] = old_letters[i - 1];
+        /* a fresh wide block starts with an empty bitmap: seed the old labels */
+        if (cls >= TRIE_WIDE_CLASS)
+            for (int i = 0; i < len + 1; ++i)
+                if (i != stop) BitmapSet(EdgeBitmap(p), p->letters[i]);
+    } else {
+        /* spare capacity: shift the upper half in place */
+        memmove(p->ptrs + stop + 1, p->ptrs + stop, (size_t)(len - stop) * sizeof(NonLeafPtr));
+        memmove(p->letters + stop + 1, p->letters + stop, (size_t)(len - stop));
     }
 
-    /* insert the new edge */
+    /* insert the new edge; the child pointer is filled in by the caller */
     p->letters[stop] = ch;
-
-    /* copy the lower half [0..stop-1] 1:1 */
-    for (int i = stop - 1; i >= 0; --i) {
-        p->ptrs[i]    = old_ptrs[i];
-        p->letters[i] = old_letters[i];
-    }
-
-    p->letters[len + 1] = '\0';
-    free(old_letters);
-    free(old_ptrs);
+    p->ptrs[stop] = NULL;
+    p->count = (unsigned)(len + 1);
+    if (cls >= TRIE_WIDE_CLASS) BitmapSet(EdgeBitmap(p), ch);
 }
 
 /* internal: create non-leaf with a single outgoing letter `ch` */
-static NonLeafPtr CreateNonLeaf(char ch) {
-    NonLeafPtr p = (NonLeafPtr)calloc(1, sizeof(*p));
-    if (!p) Error("out of memory: CreateNonLeaf");
-
+static NonLeafPtr CreateNonLeaf(TrieArena *a, char ch) {
+    NonLeafPtr p = ArenaNewNonLeaf(a);
     p->kind = !leaf;         /* 0 => non-leaf */
     p->EndOfWord = !yes;     /* 0 => false */
-    p->ptrs = (NonLeafPtr*)calloc(1, sizeof(NonLeafPtr));
-    p->letters = (char*)malloc(2);
-    if (!p->ptrs || !p->letters) Error("out of memory: CreateNonLeaf buffers");
-
-    p->letters[0] = ch;
-    p->letters[1] = '\0';
+    AddCell(a, ch, p, 0);
     return p;
 }
 
 /* internal: create an empty non-leaf (no outgoing letters) */
-static NonLeafPtr CreateEmptyNonLeaf(void) {
-    NonLeafPtr p = (NonLeafPtr)calloc(1, sizeof(*p));
-    if (!p) Error("out of memory: CreateEmptyNonLeaf");
+static NonLeafPtr CreateEmptyNonLeaf(TrieArena *a) {
+    NonLeafPtr p = ArenaNewNonLeaf(a);
     p->kind = !leaf;
     p->EndOfWord = !yes;
     return p;
 }
 
-/* internal: create/attach a leaf under edge `ch` with copied `suffix` */
-static void CreateLeaf(char ch, char *suffix, NonLeafPtr p) {
+/* internal: attach a leaf under edge `ch` whose suffix is already
+ * arena-owned (e.g. the tail of a leaf that is being split). */
+static LeafPtr AttachLeaf(TrieArena *a, char ch, char *suffix, NonLeafPtr p) {
     int pos = Position(p, ch);
-    int len = !p->letters ? 0 : (int)strlen(p->letters);
-
-    LeafPtr lf = (LeafPtr)malloc(sizeof(*lf));
-    if (!lf) Error("out of memory: CreateLeaf node");
+    int len = (int)p->count;
 
-	size_t n = strlen(suffix);
-    lf->word = (char*)malloc(n + 1);
-    if (!lf->word) Error("out of memory: CreateLeaf word");
-    memcpy(lf->word, suffix, n + 1);
+    LeafPtr lf = ArenaNewLeaf(a);
+    lf->word = suffix;
     lf->kind = leaf;
 
     if (pos == notFound) {
         /* choose sorted position for `ch` */
         for (pos = 0; pos < len && p->letters[pos] < ch; ++pos);
-        AddCell(ch, p, pos);
+        AddCell(a, ch, p, pos);
     }
     p->ptrs[pos] = (NonLeafPtr)lf;
+    return lf;
+}
+
+/* internal: create/attach a leaf under edge `ch` with copied `suffix` */
+static LeafPtr CreateLeaf(TrieArena *a, char ch, const char *suffix, NonLeafPtr p) {
+    return AttachLeaf(a, ch, ArenaSuffix(a, suffix, strlen(suffix)), p);
 }
 
 /* public: create a fresh trie seeded with the first UPPERCASED word */
 NonLeafPtr TrieCreateWithFirstWord(const char *upper_word) {
     if (!upper_word || !*upper_word) Error("TrieCreateWithFirstWord: empty word");
-    NonLeafPtr root = CreateNonLeaf(*upper_word);      /* seed root as non-leaf on first char */
+    TrieArena *a = ArenaCreate();
+    NonLeafPtr root = &a->root;                          /* root lives inside its arena */
     /* attach remaining tail (may be empty string if one-letter word) */
-    CreateLeaf(*upper_word, (char*)upper_word + 1, root);
+    CreateLeaf(a, *upper_word, upper_word + 1, root);
     return root;
 }
 
+/* public: release the trie and everything it owns in one go */
+void TrieDestroy(NonLeafPtr root) {
+    if (root) ArenaDestroy(ArenaOf(root));
+}
+
 /* ========================= *
  * Search & debug display    *
  * ========================= */
@@ -129,9 +130,12 @@ int SearchTrie(NonLeafPtr root, char *word) {
     LeafPtr lf;
     int pos;
 
+    TRIE_COUNT(searches, 1);
     while (1) {
+        TRIE_COUNT(searchNodes, 1);
         if (p->kind == leaf) {
             /* leaf holds the entire remaining suffix */
+            TRIE_COUNT(tailCompares, 1);
             lf = (LeafPtr)p;
             return strcmp(word, lf->word) == 0 ? success : !success;
         } else if (*word == '\0') {
@@ -146,14 +150,39 @@ int SearchTrie(NonLeafPtr root, char *word) {
     }
 }
 
+/* ASCII a-z -> A-Z; everything else unchanged (no locale lookup). */
+#define FOLD_ASCII(c) ((char)((unsigned char)((c) - 'a') < 26u ? (c) - ('a' - 'A') : (c)))
+
+int SearchTrieFolded(NonLeafPtr root, const char *word, size_t len) {
+    NonLeafPtr p = root;
+    int pos;
+
+    while (1) {
+        if (p->kind == leaf) {
+            /* compare the folded remainder with the leaf suffix */
+            const char *tail = ((LeafPtr)p)->word;
+            for (size_t i = 0; i < len; ++i)
+                if (tail[i] == '\0' || tail[i] != FOLD_ASCII(word[i])) return !success;
+            return tail[len] == '\0' ? success : !success;
+        } else if (len == 0) {
+            return (p->EndOfWord == yes) ? success : !success;
+        } else if ((pos = Position(p, FOLD_ASCII(*word))) != notFound && p->ptrs[pos]) {
+            p = p->ptrs[pos];
+            ++word;
+            --len;
+        } else {
+            return !success;
+        }
+    }
+}
+
 void TrieSideView(int depth, NonLeafPtr p, char *prefix) {
     if (p->kind == leaf) {
         LeafPtr lf = (LeafPtr)p;
         for (int i = 0; i < depth; ++i) printf("   ");
         printf(" >>%s|%s\n", prefix, lf->word);
     } else {
-        int n = (int)strlen(p->letters);
-        for (int i = n - 1; i >= 0; --i) {
+        for (int i = (int)p->count - 1; i >= 0; --i) {
             if (p->ptrs[i]) {
                 prefix[depth] = p->letters[i];
                 prefix[depth + 1] = '\0';
@@ -201,18 +230,19 @@ void TrieSideView(int depth, NonLeafPtr p, char *prefix) {
  *        - Free the old leaf and return.                                                *
  *                                                                                       *
  * Note about invariants:                                                                *
- * - Our traditional invariant is: letters is a valid NUL-terminated string and          *
+ * - Our traditional invariant is: letters holds `count` sorted labels and              *
  *   every letter position has a matching child pointer (or we check for NULL).          *
  * - In prefix cases (A) and (B) we intentionally create an EMPTY non-leaf:              *
  *   letters == NULL and ptrs == NULL (temporarily breaking the invariant).              *
  *   This is OK because we immediately call CreateLeaf(...) on that node, which          *
  *   allocates letters/ptrs and inserts the first outgoing edge. By the time             *
  *   TrieInsert returns, the invariant is restored.                                      *
- * - To support this, helper functions (Position, AddCell, CreateLeaf) were made         *
- *   tolerant to letters == NULL (treating it as length 0).                              *
+ * - To support this, helper functions (Position, AddCell, CreateLeaf) only look at      *
+ *   `count`, which is 0 on such a node.                                                 *
  * ===================================================================================== */
 
 void TrieInsert(char *word, NonLeafPtr root) {
+    TrieArena *a = ArenaOf(root);
     NonLeafPtr p = root;
     int pos;
 
@@ -230,7 +260,7 @@ void TrieInsert(char *word, NonLeafPtr root) {
         pos = Position(p, *word);
         if (pos == notFound) {
             /* missing edge: add as leaf carrying the whole remaining suffix */
-            CreateLeaf(*word, word + 1, p);
+            CreateLeaf(a, *word, word + 1, p);
             return;
         }
 
@@ -259,17 +289,17 @@ void TrieInsert(char *word, NonLeafPtr root) {
                 if ((int)strlen(word) == offset + 1) {
                     /* Replace the LEAF with an EMPTY non-leaf:
                        we temporarily allow letters == NULL / ptrs == NULL on this node. */
-                    p->ptrs[pos] = CreateEmptyNonLeaf();
+                    p->ptrs[pos] = CreateEmptyNonLeaf(a);
                     p->ptrs[pos]->EndOfWord = yes;   /* the NEW word ends exactly here */
+                    p->ptrs[pos]->maxWeight = lf->weight;
 
                     /* Immediately attach the remaining OLD tail as a single branch.
                        This call allocates letters/ptrs and inserts the first edge,
                        restoring the node's invariant before we return. */
-                    CreateLeaf(lf->word[offset], lf->word + offset + 1, p->ptrs[pos]);
+                    AttachLeaf(a, lf->word[offset], lf->word + offset + 1, p->ptrs[pos])->weight = lf->weight;
 
                     /* The old leaf was disconnected; free it and finish. */
-                    free(lf->word);
-                    free(lf);
+                    ArenaFreeLeaf(a, lf);
                     return;
                 }
 
@@ -277,16 +307,16 @@ void TrieInsert(char *word, NonLeafPtr root) {
                    Example (after descending the very first letter): word="AREA", lf->word="RE" */
                 else if ((int)strlen(lf->word) == offset) {
                     /* Replace the LEAF with an EMPTY non-leaf (same temporary relaxation). */
-                    p->ptrs[pos] = CreateEmptyNonLeaf();
+                    p->ptrs[pos] = CreateEmptyNonLeaf(a);
                     p->ptrs[pos]->EndOfWord = yes;   /* preserve the OLD word end here */
+                    p->ptrs[pos]->weight = p->ptrs[pos]->maxWeight = lf->weight;
 
                     /* Attach the remaining NEW tail as a single branch.
                        CreateLeaf(...) restores letters/ptrs on this node. */
-                    CreateLeaf(word[offset + 1], word + offset + 2, p->ptrs[pos]);
+                    CreateLeaf(a, word[offset + 1], word + offset + 2, p->ptrs[pos]);
 
                     /* Free the disconnected old leaf and finish. */
-                    free(lf->word);
-                    free(lf);
+                    ArenaFreeLeaf(a, lf);
                     return;
                 }
 
@@ -294,8 +324,9 @@ void TrieInsert(char *word, NonLeafPtr root) {
                    seed the NEXT letter as a non-leaf and descend into it.
                    This variant (CreateNonLeaf(letter)) keeps the usual invariant,
                    because it allocates letters/ptrs with exactly one outgoing edge. */
-                p->ptrs[pos] = CreateNonLeaf(word[offset + 1]);
+                p->ptrs[pos] = CreateNonLeaf(a, word[offset + 1]);
                 p = p->ptrs[pos];
+                p->maxWeight = lf->weight;            /* the old word lives below */
                 ++offset;
 
             } while (word[offset] == lf->word[offset - 1]);  /* continue while letters match */
@@ -307,13 +338,12 @@ void TrieInsert(char *word, NonLeafPtr root) {
              * word[offset+1] vs lf->word[offset].
              * Attach TWO branches (NEW and OLD remainders). */
             /* NEW branch */
-            CreateLeaf(word[offset + 1], word + offset + 2, p);
-            /* OLD branch */
-            CreateLeaf(lf->word[offset], lf->word + offset + 1, p);
+            CreateLeaf(a, word[offset + 1], word + offset + 2, p);
+            /* OLD branch (keeps the old word's weight) */
+            AttachLeaf(a, lf->word[offset], lf->word + offset + 1, p)->weight = lf->weight;
 
             /* old leaf was disconnected earlier; safe to free now */
-            free(lf->word);
-            free(lf);
+            ArenaFreeLeaf(a, lf);
             return;
         }
 
@@ -342,7 +372,7 @@ void TrieInsert(char *word, NonLeafPtr root) {
  *    a tight tail-matcher that accepts <=1 edit (considering current edits_used). *
  * =============================================================================== */
 
-static void add_suggestion(SuggestBox *box, const char *w) {
+void SuggestBoxAdd(SuggestBox *box, const char *w) {
     for (int i = 0; i < box->count; ++i)
         if (strcmp(box->items[i], w) == 0) return; /* de-dup */
 
@@ -355,26 +385,12 @@ static void add_suggestion(SuggestBox *box, const char *w) {
     box->items[box->count++] = copy;
 }
 
-/* Build full word from prefix + leaf suffix and add to box. */
-static void emit_word_from_prefix_and_leaf(SuggestBox *box,
-                                           const char *prefix,
-                                           const char *leaf_suffix) {
-    size_t lp = strlen(prefix), ls = strlen(leaf_suffix);
-    char *w = (char*)malloc(lp + ls + 1);
-    if (!w) return;
-    memcpy(w, prefix, lp);
-    memcpy(w + lp, leaf_suffix, ls);
-    w[lp + ls] = '\0';
-    add_suggestion(box, w);
-    free(w);
-}
-
-/* Tail matcher for <=1 edit between tailA (dict leaf suffix) and tailB (input suffix). */
-static int tailWithinOneEdit(const char *tailA, const char *tailB, int edits_used) {
-    if (edits_used > 1) return 0;
-    if (edits_used == 1) return strcmp(tailA, tailB) == 0;
-
-    if (strcmp(tailA, tailB) == 0) return 1;
+/* Edit that turns tailA (dict leaf suffix) into tailB (input suffix),
+ * given the edits already spent; notFound if more than one is needed. */
+int TailEditKind(const char *tailA, const char *tailB, int edits_used) {
+    if (edits_used > 1) return notFound;
+    if (strcmp(tailA, tailB) == 0) return editNone;
+    if (edits_used == 1) return notFound;
 
     int la = (int)strlen(tailA), lb = (int)strlen(tailB);
 
@@ -384,19 +400,19 @@ static int tailWithinOneEdit(const char *tailA, const char *tailB, int edits_use
         for (int i = 0; i < la; ++i) {
             if (tailA[i] != tailB[i]) { diff++; if (diff > 1) break; }
         }
-        if (diff == 1) return 1;
+        if (diff == 1) return editSubstitution;
 
         /* adjacent transposition */
         for (int i = 0; i + 1 < la; ++i) {
             if (tailA[i] != tailB[i]) {
                 if (tailA[i] == tailB[i + 1] && tailA[i + 1] == tailB[i]) {
                     if (strncmp(tailA + i + 2, tailB + i + 2, la - (i + 2)) == 0)
-                        return 1;
+                        return editTransposition;
                 }
                 break;
             }
         }
-        return 0;
+        return notFound;
     }
 
     /* insertion (extra char in input): skip one in tailB */
@@ -405,9 +421,9 @@ static int tailWithinOneEdit(const char *tailA, const char *tailB, int edits_use
         while (i < la && j < lb) {
             if (tailA[i] == tailB[j]) { ++i; ++j; }
             else if (!skipped) { skipped = 1; ++j; }
-            else return 0;
+            else return notFound;
         }
-        return 1;
+        return editInsertion;
     }
 
     /* deletion (missing char in input): skip one in tailA */
@@ -416,91 +432,112 @@ static int tailWithinOneEdit(const char *tailA, const char *tailB, int edits_use
         while (i < la && j < lb) {
             if (tailA[i] == tailB[j]) { ++i; ++j; }
             else if (!skipped) { skipped = 1; ++i; }
-            else return 0;
+            else return notFound;
         }
-        return 1;
+        return editDeletion;
     }
 
-    return 0;
+    return notFound;
+}
+
+/* Tail matcher for <=1 edit between tailA (dict leaf suffix) and tailB (input suffix). */
+int TailWithinOneEdit(const char *tailA, const char *tailB, int edits_used) {
+    TRIE_COUNT(tailCompares, 1);
+    return TailEditKind(tailA, tailB, edits_used) != notFound;
 }
 
-/* DFS with at most one edit. See header for move semantics. */
+/* The walk ends once the result is full or the budget ran out. */
+#define DFS_DONE(out, max) ((out)->count >= (max) || (out)->truncated)
+
+/* DFS with at most one edit. See header for move semantics. `budget` is
+ * charged one unit per node entered (NULL: unlimited). */
 static void dfsSuggest(NonLeafPtr p, const char *in, int idx,
                        char *prefix, int plen, int edits_used,
-                       SuggestBox *box, int MAX_SUGG) {
-    if (box->count >= MAX_SUGG) return;
+                       SuggestResult *out, int MAX_SUGG, SuggestBudget *budget) {
+    if (DFS_DONE(out, MAX_SUGG)) return;
+    if (budget && !BudgetCharge(budget)) {
+        out->truncated = 1;
+        return;
+    }
+    TRIE_COUNT(suggestNodes, 1);
 
     if (in[idx] == '\0' && p->EndOfWord == yes) {
         prefix[plen] = '\0';
-        add_suggestion(box, prefix);
-        if (box->count >= MAX_SUGG) return;
+        ResultAddWord(out, prefix, "");
+        if (DFS_DONE(out, MAX_SUGG)) return;
     }
 
-    int n = (int)strlen(p->letters);
+    int n = (int)p->count;
 
     /* Insertion (extra input char): consume in[idx] and stay on this node. */
     if (edits_used == 0 && in[idx] != '\0') {
-        dfsSuggest(p, in, idx + 1, prefix, plen, 1, box, MAX_SUGG);
-        if (box->count >= MAX_SUGG) return;
+        TRIE_COUNT(editsExplored, 1);
+        dfsSuggest(p, in, idx + 1, prefix, plen, 1, out, MAX_SUGG, budget);
+        if (DFS_DONE(out, MAX_SUGG)) return;
     }
 
-    for (int i = 0; i < n && box->count < MAX_SUGG; ++i) {
+    for (int i = 0; i < n && !DFS_DONE(out, MAX_SUGG); ++i) {
         char edge = p->letters[i];
         NonLeafPtr child = p->ptrs[i];
 
+        if (edits_used != 0 && in[idx] != edge) TRIE_COUNT(cutoffs, 1);
+
         /* exact match */
         if (in[idx] != '\0' && in[idx] == edge) {
             prefix[plen] = edge; prefix[plen + 1] = '\0';
             if (child->kind == leaf) {
                 LeafPtr lf = (LeafPtr)child;
-                if (tailWithinOneEdit(lf->word, in + idx + 1, edits_used))
-                    emit_word_from_prefix_and_leaf(box, prefix, lf->word);
+                if (TailWithinOneEdit(lf->word, in + idx + 1, edits_used))
+                    ResultAddWord(out, prefix, lf->word);
             } else {
-                dfsSuggest(child, in, idx + 1, prefix, plen + 1, edits_used, box, MAX_SUGG);
+                dfsSuggest(child, in, idx + 1, prefix, plen + 1, edits_used, out, MAX_SUGG, budget);
             }
-            if (box->count >= MAX_SUGG) return;
+            if (DFS_DONE(out, MAX_SUGG)) return;
         }
 
         /* substitution */
         if (edits_used == 0 && in[idx] != '\0' && in[idx] != edge) {
+            TRIE_COUNT(editsExplored, 1);
             prefix[plen] = edge; prefix[plen + 1] = '\0';
             if (child->kind == leaf) {
                 LeafPtr lf = (LeafPtr)child;
-                if (tailWithinOneEdit(lf->word, in + idx + 1, 1))
-                    emit_word_from_prefix_and_leaf(box, prefix, lf->word);
+                if (TailWithinOneEdit(lf->word, in + idx + 1, 1))
+                    ResultAddWord(out, prefix, lf->word);
             } else {
-                dfsSuggest(child, in, idx + 1, prefix, plen + 1, 1, box, MAX_SUGG);
+                dfsSuggest(child, in, idx + 1, prefix, plen + 1, 1, out, MAX_SUGG, budget);
             }
-            if (box->count >= MAX_SUGG) return;
+            if (DFS_DONE(out, MAX_SUGG)) return;
         }
 
         /* deletion: go down without consuming input */
         if (edits_used == 0) {
+            TRIE_COUNT(editsExplored, 1);
             prefix[plen] = edge; prefix[plen + 1] = '\0';
             if (child->kind == leaf) {
                 LeafPtr lf = (LeafPtr)child;
-                if (tailWithinOneEdit(lf->word, in + idx, 1))
-                    emit_word_from_prefix_and_leaf(box, prefix, lf->word);
+                if (TailWithinOneEdit(lf->word, in + idx, 1))
+                    ResultAddWord(out, prefix, lf->word);
             } else {
-                dfsSuggest(child, in, idx, prefix, plen + 1, 1, box, MAX_SUGG);
+                dfsSuggest(child, in, idx, prefix, plen + 1, 1, out, MAX_SUGG, budget);
             }
-            if (box->count >= MAX_SUGG) return;
+            if (DFS_DONE(out, MAX_SUGG)) return;
         }
     }
 
     /* adjacent transposition: consume in[idx+1] first, then in[idx] */
-    if (edits_used == 0 && in[idx] != '\0' && in[idx + 1] != '\0') {
+    if (edits_used == 0 && in[idx] != '\0' && in[idx + 1] != '\0' && !out->truncated) {
         int pos1 = Position(p, in[idx + 1]);
         if (pos1 != notFound && p->ptrs[pos1]) {
             NonLeafPtr c1 = p->ptrs[pos1];
+            TRIE_COUNT(editsExplored, 1);
 
             prefix[plen] = in[idx + 1]; prefix[plen + 1] = '\0';
 
             if (c1->kind == leaf) {
                 LeafPtr lf1 = (LeafPtr)c1;
                 if (lf1->word[0] == in[idx]) {
-                    if (tailWithinOneEdit(lf1->word + 1, in + idx + 2, 1))
-                        emit_word_from_prefix_and_leaf(box, prefix, lf1->word);
+                    if (TailWithinOneEdit(lf1->word + 1, in + idx + 2, 1))
+                        ResultAddWord(out, prefix, lf1->word);
                 }
             } else {
                 int pos2 = Position(c1, in[idx]);
@@ -511,10 +548,10 @@ static void dfsSuggest(NonLeafPtr p, const char *in, int idx,
 
                     if (c2->kind == leaf) {
                         LeafPtr lf2 = (LeafPtr)c2;
-                        if (tailWithinOneEdit(lf2->word, in + idx + 2, 1))
-                            emit_word_from_prefix_and_leaf(box, prefix, lf2->word);
+                        if (TailWithinOneEdit(lf2->word, in + idx + 2, 1))
+                            ResultAddWord(out, prefix, lf2->word);
                     } else {
-                        dfsSuggest(c2, in, idx + 2, prefix, plen + 2, 1, box, MAX_SUGG);
+                        dfsSuggest(c2, in, idx + 2, prefix, plen + 2, 1, out, MAX_SUGG, budget);
                     }
                 }
             }
@@ -522,17 +559,60 @@ static void dfsSuggest(NonLeafPtr p, const char *in, int idx,
     }
 }
 
+void SuggestCorrectionsInto(NonLeafPtr root, const char *upper_word,
+                            int maxSuggestions, SuggestResult *out) {
+    ResultReset(out, maxSuggestions);
+    TRIE_COUNT(suggests, 1);
+
+    char small[256];
+    char *prefix = SuggestPrefixBuffer(small, sizeof(small), upper_word);
+
+    dfsSuggest(root, upper_word, 0, prefix, 0, 0, out, out->cap, NULL);
+    SuggestPrefixFree(prefix, small);
+}
+
+void SuggestCorrectionsWithOptions(NonLeafPtr root, const char *upper_word, int maxSuggestions,
+                                   const SuggestOptions *opts, SuggestResult *out) {
+    if (!opts) {
+        SuggestCorrectionsInto(root, upper_word, maxSuggestions, out);
+        return;
+    }
+    ResultReset(out, maxSuggestions);
+    if (opts->prefilter && SuggestPrefilterRejects(opts, upper_word)) return;
+    TRIE_COUNT(suggests, 1);
+
+    SuggestBudget budget;
+    budget.nodes = 0;
+    budget.maxNodes = opts->maxNodes;
+    budget.deadlineNs = opts->deadlineNs;
+    if (budget.deadlineNs && TrieNowNs() >= budget.deadlineNs) {
+        out->truncated = 1;
+        return;
+    }
+
+    char small[256];
+    char *prefix = SuggestPrefixBuffer(small, sizeof(small), upper_word);
+    dfsSuggest(root, upper_word, 0, prefix, 0, 0, out, out->cap, &budget);
+    SuggestPrefixFree(prefix, small);
+}
+
 void SuggestCorrections(NonLeafPtr root, const char *upper_word,
                         int maxSuggestions, SuggestBox *outBox) {
-    outBox->count = 0;
-    outBox->cap   = maxSuggestions;
-    outBox->items = (char**)calloc((size_t)maxSuggestions, sizeof(char*));
-    if (!outBox->items) { outBox->cap = 0; return; }
+    if (!SuggestBoxInit(outBox, maxSuggestions)) return;
 
-    char prefix[256];
-    prefix[0] = '\0';
+    SuggestResult r;
+    SuggestResultInit(&r);
+    SuggestCorrectionsInto(root, upper_word, maxSuggestions, &r);
+    ResultToBox(&r, outBox);
+    SuggestResultFree(&r);
+}
 
-    dfsSuggest(root, upper_word, 0, prefix, 0, 0, outBox, maxSuggestions);
+int SuggestBoxInit(SuggestBox *box, int maxSuggestions) {
+    box->count = 0;
+    box->cap   = maxSuggestions;
+    box->items = (char**)calloc((size_t)maxSuggestions, sizeof(char*));
+    if (!box->items) { box->cap = 0; return 0; }
+    return 1;
 }
 
 void FreeSuggestBox(SuggestBox *box) {
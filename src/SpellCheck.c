@@ -0,0 +1,255 @@
+#include "SimpleTrieSpellChecker.h"
+#include "TriePlatform.h"
+#include "TextScan.h"
+#include "TrieSuggest.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ================================================================ *
+ * Buffer / file checking                                           *
+ *                                                                  *
+ * Tokens are maximal runs of letters: ASCII letters (the set the   *
+ * demo got from isalpha() in the "C" locale) plus the letters of   *
+ * UTF-8 encoded text. TextScan.c finds them and counts '\n' for    *
+ * line numbers 64 bytes at a time with SIMD masks, and every token *
+ * is looked up with SearchTrieFolded, which uppercases on the fly: *
+ * no stdio per character, no token copy, no strupr pass.           *
+ * ================================================================ */
+
+#define SPELL_BLOCK       (1u << 20)  /* SpellCheckFile read size */
+#define SPELL_MIN_CHUNK   (64u << 10) /* smallest parallel work unit */
+#define SPELL_CHUNKS_PER_THREAD 8     /* load balancing granularity */
+#define SPELL_SUGGEST_BATCH     64    /* misspellings per SuggestCorrectionsBatch */
+
+static void PushMisspelling(MisspellingList *out, size_t offset, size_t length, size_t line) {
+    if (out->count == out->cap) {
+        size_t cap = out->cap ? out->cap * 2 : 64;
+        Misspelling *items = (Misspelling*)realloc(out->items, cap * sizeof(Misspelling));
+        if (!items) Error("out of memory: PushMisspelling");
+        out->items = items;
+        out->cap = cap;
+    }
+    out->items[out->count].offset = offset;
+    out->items[out->count].length = length;
+    out->items[out->count].line   = line;
+    memset(&out->items[out->count].suggestions, 0, sizeof(SuggestBox));
+    out->count++;
+}
+
+typedef struct {
+    NonLeafPtr root;
+    const char *buf;
+    size_t base;                  /* offset of buf[0] in the whole input */
+    MisspellingList *out;
+} TokenCheck;
+
+static void CheckToken(void *ctx, size_t start, size_t len, size_t line) {
+    TokenCheck *tc = (TokenCheck*)ctx;
+    if (SearchTrieFolded(tc->root, tc->buf + start, len) != success)
+        PushMisspelling(tc->out, tc->base + start, len, line);
+}
+
+/* Check the tokens of buf[0..len); `base` is the offset of buf[0] in the
+ * whole input. Unless `final`, the tail after the last ASCII separator may
+ * continue in the next block: it is left unscanned and the returned count
+ * of consumed bytes stops before it. */
+static size_t ScanTokens(NonLeafPtr root, const char *buf, size_t len, int final,
+                         size_t base, size_t *line, MisspellingList *out) {
+    TokenCheck tc;
+    tc.root = root;
+    tc.buf = buf;
+    tc.base = base;
+    tc.out = out;
+
+    if (!final) len = ScanSafeEnd(buf, len);
+    ScanText(buf, len, line, CheckToken, &tc);
+    return len;
+}
+
+size_t SpellCheckBuffer(NonLeafPtr root, const char *buf, size_t len,
+                        MisspellingList *out) {
+    size_t before = out->count, line = 1;
+    ScanTokens(root, buf, len, 1, 0, &line, out);
+    return out->count - before;
+}
+
+/* ========================= *
+ * Parallel checking         *
+ * ========================= *
+ * The input is cut into chunks (several per thread) whose boundaries  *
+ * are moved forward to just after an ASCII separator, so no token or  *
+ * UTF-8 sequence is split. Workers claim chunks through an atomic     *
+ * counter and write into per-chunk lists with chunk-relative line     *
+ * numbers; the merge then concatenates the lists in chunk order and   *
+ * rebases lines by the newline counts of the preceding chunks.        */
+
+typedef struct {
+    size_t start, end;            /* chunk bytes [start, end) */
+    size_t newlines;              /* newlines seen inside the chunk */
+    MisspellingList list;         /* lines are 0-based within the chunk */
+} SpellChunk;
+
+typedef struct {
+    NonLeafPtr root;
+    const char *buf;
+    int maxSuggestions;
+    SuggestCache *cache;          /* optional */
+    SpellChunk *chunks;
+    long nChunks;
+    volatile long next;           /* next unclaimed chunk */
+} SpellJob;
+
+/* Suggestions for the misspellings of one chunk, SPELL_SUGGEST_BATCH at a
+ * time through SuggestCorrectionsBatch (uppercased, NUL-terminated copies
+ * of the tokens back to back in one buffer). */
+static void SuggestForList(NonLeafPtr root, const char *buf, MisspellingList *list,
+                           int maxSuggestions) {
+    const char *words[SPELL_SUGGEST_BATCH];
+    SuggestResult results[SPELL_SUGGEST_BATCH];
+    char *copies = NULL;
+    size_t copiesCap = 0;
+
+    for (int i = 0; i < SPELL_SUGGEST_BATCH; ++i) SuggestResultInit(&results[i]);
+    for (size_t first = 0; first < list->count; first += SPELL_SUGGEST_BATCH) {
+        size_t n = list->count - first < SPELL_SUGGEST_BATCH ? list->count - first : SPELL_SUGGEST_BATCH;
+        size_t bytes = 0;
+        for (size_t m = 0; m < n; ++m) bytes += list->items[first + m].length + 1;
+        if (bytes > copiesCap) {
+            free(copies);
+            copies = (char*)malloc(bytes);
+            if (!copies) Error("out of memory: SuggestForList");
+            copiesCap = bytes;
+        }
+
+        char *w = copies;
+        for (size_t m = 0; m < n; ++m) {
+            const Misspelling *ms = &list->items[first + m];
+            ScanUpperCopy(w, buf + ms->offset, ms->length);
+            w[ms->length] = '\0';
+            words[m] = w;
+            w += ms->length + 1;
+        }
+        SuggestCorrectionsBatch(root, words, n, maxSuggestions, results);
+        for (size_t m = 0; m < n; ++m) {
+            SuggestBox *box = &list->items[first + m].suggestions;
+            if (SuggestBoxInit(box, maxSuggestions)) ResultToBox(&results[m], box);
+        }
+    }
+    for (int i = 0; i < SPELL_SUGGEST_BATCH; ++i) SuggestResultFree(&results[i]);
+    free(copies);
+}
+
+static void SpellWorker(void *ctx, int idx) {
+    SpellJob *job = (SpellJob*)ctx;
+    (void)idx;
+
+    long k;
+    while ((k = TrieAtomicFetchAdd(&job->next, 1)) < job->nChunks) {
+        SpellChunk *c = &job->chunks[k];
+        size_t line = 0;
+        ScanTokens(job->root, job->buf + c->start, c->end - c->start, 1,
+                   c->start, &line, &c->list);
+        c->newlines = line;
+
+        if (job->maxSuggestions > 0 && job->cache)
+            for (size_t m = 0; m < c->list.count; ++m) {
+                Misspelling *ms = &c->list.items[m];
+                SuggestCached(job->cache, job->buf + ms->offset, ms->length,
+                              job->maxSuggestions, &ms->suggestions);
+            }
+        else if (job->maxSuggestions > 0)
+            SuggestForList(job->root, job->buf, &c->list, job->maxSuggestions);
+    }
+}
+
+size_t SpellCheckBufferParallel(NonLeafPtr root, const char *buf, size_t len,
+                                int threads, int maxSuggestions,
+                                SuggestCache *cache, MisspellingList *out) {
+    if (threads <= 0) threads = TrieCpuCount();
+
+    size_t nChunks = (size_t)threads * SPELL_CHUNKS_PER_THREAD;
+    if (len / SPELL_MIN_CHUNK < nChunks) nChunks = len / SPELL_MIN_CHUNK;
+    if (nChunks == 0) nChunks = 1;
+    if ((size_t)threads > nChunks) threads = (int)nChunks;
+
+    SpellJob job;
+    job.root = root;
+    job.buf = buf;
+    job.maxSuggestions = maxSuggestions;
+    job.cache = cache;
+    job.chunks = (SpellChunk*)calloc(nChunks, sizeof(SpellChunk));
+    job.nChunks = (long)nChunks;
+    job.next = 0;
+    if (!job.chunks) Error("out of memory: SpellCheckBufferParallel");
+
+    /* cut points never split a token */
+    size_t prev = 0;
+    for (size_t k = 0; k < nChunks; ++k) {
+        size_t end = k + 1 == nChunks ? len : len / nChunks * (k + 1);
+        if (end < prev) end = prev;
+        while (end > 0 && end < len && !ScanIsSeparator(buf[end - 1]))
+            ++end;
+        job.chunks[k].start = prev;
+        job.chunks[k].end = end;
+        prev = end;
+    }
+
+    TrieRunThreads(threads, SpellWorker, &job);
+
+    /* deterministic merge in input order */
+    size_t before = out->count, lineBase = 1;
+    for (size_t k = 0; k < nChunks; ++k) {
+        SpellChunk *c = &job.chunks[k];
+        for (size_t m = 0; m < c->list.count; ++m) {
+            const Misspelling *ms = &c->list.items[m];
+            PushMisspelling(out, ms->offset, ms->length, ms->line + lineBase);
+            out->items[out->count - 1].suggestions = ms->suggestions;
+        }
+        lineBase += c->newlines;
+        free(c->list.items);              /* suggestions moved to `out` */
+    }
+    free(job.chunks);
+    return out->count - before;
+}
+
+int SpellCheckFile(NonLeafPtr root, const char *path, MisspellingList *out) {
+    FILE *f = fopen(path, "rb");
+    if (!f) return !success;
+
+    size_t cap = SPELL_BLOCK, have = 0, base = 0, line = 1;
+    char *buf = (char*)malloc(cap);
+    if (!buf) Error("out of memory: SpellCheckFile");
+
+    while (1) {
+        have += fread(buf + have, 1, cap - have, f);
+        int final = feof(f) || ferror(f);
+        size_t used = ScanTokens(root, buf, have, final, base, &line, out);
+        if (final) break;
+
+        /* keep the unfinished tail; grow if it fills the whole block */
+        memmove(buf, buf + used, have - used);
+        have -= used;
+        base += used;
+        if (have == cap) {
+            char *bigger = (char*)realloc(buf, cap * 2);
+            if (!bigger) Error("out of memory: SpellCheckFile");
+            buf = bigger;
+            cap *= 2;
+        }
+    }
+
+    int rc = ferror(f) ? !success : success;
+    free(buf);
+    fclose(f);
+    return rc;
+}
+
+void FreeMisspellingList(MisspellingList *list) {
+    if (!list) return;
+    for (size_t i = 0; i < list->count; ++i)
+        FreeSuggestBox(&list->items[i].suggestions);
+    free(list->items);
+    list->items = NULL;
+    list->count = list->cap = 0;
+}
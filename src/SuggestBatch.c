@@ -0,0 +1,287 @@
+#include "TrieNode.h"
+#include "TrieSuggest.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* ================================================================ *
+ * Batch suggestions (one shared DFS)                               *
+ *                                                                  *
+ * SuggestCorrectionsInto walks the trie once per word, so a batch  *
+ * of typos pays for the root fan-out and the shared upper levels   *
+ * once per word. Here the words are sorted first: the words that   *
+ * can still match a node exactly (no edit spent) are then a        *
+ * contiguous run of the sorted batch, and the walk visits each     *
+ * node once for the whole run, splitting it by next byte on the    *
+ * way down.                                                        *
+ *                                                                  *
+ * At every node each word of the run spends its one edit the ways  *
+ * dfsSuggest would (insertion, substitution and deletion per edge, *
+ * transposition). Once the edit is spent the rest must match       *
+ * exactly, which is a single path: it is followed right away by a  *
+ * plain lookup loop instead of a recursive search.                 *
+ *                                                                  *
+ * Per word, dfsSuggest emits words in a fixed order: at the depth  *
+ * where the edit is spent, exact word < insertion < edge i (exact  *
+ * recursion < substitution < deletion) < transposition. Each word  *
+ * found here is tagged with that depth and slot; sorting a query's *
+ * words by tag (descending through its exact path) and adding them *
+ * with de-duplication and the cap gives the same list, in the same *
+ * order, as one SuggestCorrectionsInto call per word.              *
+ * ================================================================ */
+
+typedef struct {
+    const char *w;
+    int q;                        /* index in the caller's batch */
+} BatchQuery;
+
+typedef struct {
+    int q, level, slot;
+    size_t word;                  /* offset in bytes */
+} BatchCand;
+
+typedef struct {
+    const BatchQuery *ord;        /* the batch, sorted by word */
+    BatchCand *cand;
+    size_t nCand, capCand;
+    char *bytes;                  /* candidate words, NUL-terminated */
+    size_t used, capBytes;
+    char *prefix;                 /* path of the current node */
+    size_t capPrefix;
+    int *exact;                   /* exact[exactOff[q] + d]: slot of q's exact edge at depth d */
+    size_t *exactOff;
+} Batch;
+
+/* Slots at one depth, in dfsSuggest order. */
+#define SLOT_WORD           0
+#define SLOT_INSERT         1
+#define SLOT_EXACT(i)       (2 + 3 * (i))
+#define SLOT_SUBST(i)       (3 + 3 * (i))
+#define SLOT_DELETE(i)      (4 + 3 * (i))
+#define SLOT_TRANSPOSE(n)   (2 + 3 * (n))
+
+static void *GrowArray(void *p, size_t *cap, size_t need, size_t size) {
+    if (need <= *cap) return p;
+    size_t n = *cap ? *cap : 64;
+    while (n < need) n *= 2;
+    p = realloc(p, n * size);
+    if (!p) Error("out of memory: SuggestCorrectionsBatch");
+    *cap = n;
+    return p;
+}
+
+static int CompareQueries(const void *a, const void *b) {
+    const BatchQuery *x = (const BatchQuery*)a, *y = (const BatchQuery*)b;
+    int cmp = strcmp(x->w, y->w);
+    return cmp != 0 ? cmp : (x->q > y->q) - (x->q < y->q);
+}
+
+/* Record prefix[0..plen) + mid[0..midLen) + tail for query q. */
+static void AddCand(Batch *b, int q, int level, int slot, int plen,
+                    const char *mid, size_t midLen, const char *tail) {
+    size_t lt = strlen(tail);
+    size_t len = (size_t)plen + midLen + lt;
+    b->bytes = (char*)GrowArray(b->bytes, &b->capBytes, b->used + len + 1, 1);
+    b->cand = (BatchCand*)GrowArray(b->cand, &b->capCand, b->nCand + 1, sizeof(BatchCand));
+
+    char *w = b->bytes + b->used;
+    memcpy(w, b->prefix, (size_t)plen);
+    memcpy(w + plen, mid, midLen);
+    memcpy(w + plen + midLen, tail, lt + 1);
+
+    BatchCand *c = &b->cand[b->nCand++];
+    c->q = q;
+    c->level = level;
+    c->slot = slot;
+    c->word = b->used;
+    b->used += len + 1;
+}
+
+/* The edit is spent: does `s` continue from p (a leaf or not) to the end
+ * of a word? Returns the leaf tail after the *used bytes of s ("" for a
+ * word ending at a node), or NULL. */
+static const char *WalkExact(NonLeafPtr p, const char *s, size_t *used) {
+    size_t j = 0;
+    while (1) {
+        if (p->kind == leaf) {
+            const char *t = ((LeafPtr)p)->word;
+            TRIE_COUNT(tailCompares, 1);
+            if (strcmp(t, s + j) != 0) return NULL;
+            *used = j;
+            return t;
+        }
+        TRIE_COUNT(suggestNodes, 1);
+        if (s[j] == '\0') {
+            if (p->EndOfWord != yes) return NULL;
+            *used = j;
+            return "";
+        }
+        int pos = Position(p, s[j]);
+        if (pos == notFound || !p->ptrs[pos]) return NULL;
+        p = p->ptrs[pos];
+        ++j;
+    }
+}
+
+/* Spend the edit of query e by continuing with s from p; the path so far
+ * is prefix[0..plen). */
+static void EditWalk(Batch *b, const BatchQuery *e, int level, int slot,
+                     NonLeafPtr p, int plen, const char *s) {
+    size_t used;
+    const char *t = WalkExact(p, s, &used);
+    if (t) AddCand(b, e->q, level, slot, plen, s, used, t);
+}
+
+/* Visit p at depth d with the queries ord[lo..hi), whose first d bytes
+ * spell the path to p. */
+static void dfsBatch(Batch *b, NonLeafPtr p, int d, size_t lo, size_t hi) {
+    const BatchQuery *ord = b->ord;
+    int n = (int)p->count;
+
+    TRIE_COUNT(suggestNodes, 1);
+    b->prefix = (char*)GrowArray(b->prefix, &b->capPrefix, (size_t)d + 3, 1);
+
+    /* every child is entered by some deletion: start all the misses at once */
+    for (int i = 0; i < n; ++i)
+        if (p->ptrs[i]) TriePrefetch(p->ptrs[i]);
+
+    /* the word ending here, insertion, transposition */
+    for (size_t k = lo; k < hi; ++k) {
+        const char *w = ord[k].w + d;
+        if (w[0] == '\0') {
+            if (p->EndOfWord == yes) AddCand(b, ord[k].q, d, SLOT_WORD, d, "", 0, "");
+            continue;
+        }
+        TRIE_COUNT(editsExplored, 1);
+        EditWalk(b, &ord[k], d, SLOT_INSERT, p, d, w + 1);
+
+        if (w[1] == '\0') continue;
+        int pos1 = Position(p, w[1]);
+        if (pos1 == notFound || !p->ptrs[pos1]) continue;
+        NonLeafPtr c1 = p->ptrs[pos1];
+        TRIE_COUNT(editsExplored, 1);
+        b->prefix[d] = w[1];
+        if (c1->kind == leaf) {
+            const char *t = ((LeafPtr)c1)->word;
+            if (t[0] == w[0] && TailWithinOneEdit(t + 1, w + 2, 1))
+                AddCand(b, ord[k].q, d, SLOT_TRANSPOSE(n), d + 1, "", 0, t);
+            continue;
+        }
+        int pos2 = Position(c1, w[0]);
+        if (pos2 == notFound || !c1->ptrs[pos2]) continue;
+        b->prefix[d + 1] = w[0];
+        EditWalk(b, &ord[k], d, SLOT_TRANSPOSE(n), c1->ptrs[pos2], d + 2, w + 2);
+    }
+
+    /* per edge: substitution and deletion (and the exact match into a leaf) */
+    for (int i = 0; i < n; ++i) {
+        NonLeafPtr child = p->ptrs[i];
+        char edge = p->letters[i];
+        if (!child) continue;
+        b->prefix[d] = edge;
+
+        if (child->kind == leaf) {
+            const char *t = ((LeafPtr)child)->word;
+            for (size_t k = lo; k < hi; ++k) {
+                const char *w = ord[k].w + d;
+                if (w[0] != '\0' && w[0] == edge) {
+                    if (TailWithinOneEdit(t, w + 1, 0)) AddCand(b, ord[k].q, d, SLOT_EXACT(i), d + 1, "", 0, t);
+                } else if (w[0] != '\0') {
+                    if (TailWithinOneEdit(t, w + 1, 1)) AddCand(b, ord[k].q, d, SLOT_SUBST(i), d + 1, "", 0, t);
+                }
+                if (TailWithinOneEdit(t, w, 1)) AddCand(b, ord[k].q, d, SLOT_DELETE(i), d + 1, "", 0, t);
+            }
+            continue;
+        }
+        for (size_t k = lo; k < hi; ++k) {
+            const char *w = ord[k].w + d;
+            TRIE_COUNT(editsExplored, 1);
+            if (w[0] != '\0' && w[0] != edge) EditWalk(b, &ord[k], d, SLOT_SUBST(i), child, d + 1, w + 1);
+            EditWalk(b, &ord[k], d, SLOT_DELETE(i), child, d + 1, w);
+        }
+    }
+
+    /* exact matches: each run of queries with the same next byte goes down together */
+    size_t k = lo;
+    while (k < hi && ord[k].w[d] == '\0') ++k;
+    while (k < hi) {
+        char c = ord[k].w[d];
+        size_t run = k;
+        while (k < hi && ord[k].w[d] == c) ++k;
+
+        int pos = Position(p, c);
+        if (pos == notFound || !p->ptrs[pos] || p->ptrs[pos]->kind == leaf) continue;
+        for (size_t r = run; r < k; ++r)
+            b->exact[b->exactOff[ord[r].q] + (size_t)d] = SLOT_EXACT(pos);
+        b->prefix[d] = c;
+        dfsBatch(b, p->ptrs[pos], d + 1, run, k);
+    }
+}
+
+/* Does a come before b in q's dfsSuggest order? `exact` is q's exact path. */
+static int CandBefore(const BatchCand *a, const BatchCand *b, const int *exact) {
+    int m = a->level < b->level ? a->level : b->level;
+    int ka = a->level == m ? a->slot : exact[m];
+    int kb = b->level == m ? b->slot : exact[m];
+    return ka < kb;
+}
+
+void SuggestCorrectionsBatch(NonLeafPtr root, const char *const *upper_words, size_t count,
+                             int maxSuggestions, SuggestResult *outs) {
+    Batch b;
+    memset(&b, 0, sizeof(b));
+
+    for (size_t q = 0; q < count; ++q) ResultReset(&outs[q], maxSuggestions);
+    if (count == 0 || maxSuggestions <= 0) return;
+
+    BatchQuery *ord = (BatchQuery*)malloc(count * sizeof(BatchQuery));
+    b.exactOff = (size_t*)malloc((count + 1) * sizeof(size_t));
+    if (!ord || !b.exactOff) Error("out of memory: SuggestCorrectionsBatch");
+    b.exactOff[0] = 0;
+    for (size_t q = 0; q < count; ++q) {
+        ord[q].w = upper_words[q];
+        ord[q].q = (int)q;
+        b.exactOff[q + 1] = b.exactOff[q] + strlen(upper_words[q]) + 1;
+    }
+    b.exact = (int*)malloc(b.exactOff[count] * sizeof(int));
+    if (!b.exact) Error("out of memory: SuggestCorrectionsBatch");
+    qsort(ord, count, sizeof(BatchQuery), CompareQueries);
+    b.ord = ord;
+
+    TRIE_COUNT(suggests, count);
+    dfsBatch(&b, root, 0, 0, count);
+
+    /* group the words by query (stable), order each group, fill the results */
+    size_t *first = (size_t*)calloc(count + 1, sizeof(size_t));
+    BatchCand *sorted = (BatchCand*)malloc((b.nCand ? b.nCand : 1) * sizeof(BatchCand));
+    if (!first || !sorted) Error("out of memory: SuggestCorrectionsBatch");
+    for (size_t c = 0; c < b.nCand; ++c) ++first[b.cand[c].q + 1];
+    for (size_t q = 0; q < count; ++q) first[q + 1] += first[q];
+    for (size_t c = 0; c < b.nCand; ++c) sorted[first[b.cand[c].q]++] = b.cand[c];
+
+    size_t lo = 0;
+    for (size_t q = 0; q < count; ++q) {
+        size_t hi = first[q];
+        const int *exact = b.exact + b.exactOff[q];
+        for (size_t i = lo + 1; i < hi; ++i) {            /* insertion sort: groups are small */
+            BatchCand c = sorted[i];
+            size_t j = i;
+            while (j > lo && CandBefore(&c, &sorted[j - 1], exact)) {
+                sorted[j] = sorted[j - 1];
+                --j;
+            }
+            sorted[j] = c;
+        }
+        for (size_t i = lo; i < hi && outs[q].count < outs[q].cap; ++i)
+            ResultAddWord(&outs[q], b.bytes + sorted[i].word, "");
+        lo = hi;
+    }
+
+    free(first);
+    free(sorted);
+    free(ord);
+    free(b.cand);
+    free(b.bytes);
+    free(b.prefix);
+    free(b.exact);
+    free(b.exactOff);
+}
@@ -0,0 +1,274 @@
+#include "SimpleTrieSpellChecker.h"
+#include "TriePlatform.h"
+#include "TrieSuggest.h"
+#include "TextScan.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ================================================================ *
+ * Suggestion cache                                                 *
+ *                                                                  *
+ * Misspelled tokens map (uppercased) to the suggestion list they   *
+ * produced. The cache is split into CACHE_SHARDS independent       *
+ * shards picked by the key hash; each shard has its own mutex,     *
+ * chained hash table and LRU list, and gets an equal slice of the  *
+ * memory cap. Threads only contend when their keys land in the     *
+ * same shard, and the lock is never held while the trie is walked. *
+ *                                                                  *
+ * An entry is one allocation: the header, the key and the          *
+ * suggestions as consecutive NUL-terminated strings. A list        *
+ * computed for cap N also answers every request with cap <= N      *
+ * (dfsSuggest emits in a fixed order, so the shorter list is a     *
+ * prefix), and any cap at all if it came out shorter than N.       *
+ * ================================================================ */
+
+#define CACHE_SHARDS      16
+#define CACHE_MIN_BUCKETS 64
+
+typedef struct CacheEntry {
+    struct CacheEntry *chain;          /* next entry in the hash bucket */
+    struct CacheEntry *newer, *older;  /* LRU list links */
+    uint32_t hash;
+    uint32_t keyLen;
+    int      cap;                      /* maxSuggestions used to compute the list */
+    int      count;                    /* suggestions stored */
+    size_t   bytes;                    /* size of this allocation */
+    /* followed by: key '\0' suggestion '\0' suggestion '\0' ... */
+} CacheEntry;
+
+typedef struct {
+    TrieMutex   *lock;
+    CacheEntry **buckets;
+    size_t       nBuckets;             /* power of two */
+    size_t       entries;
+    size_t       bytes;                /* entries + bucket table */
+    CacheEntry  *newest, *oldest;
+    unsigned long long hits, misses, evictions;
+} CacheShard;
+
+struct SuggestCache {
+    NonLeafPtr root;
+    size_t     maxBytes;
+    size_t     shardBytes;             /* per-shard share of maxBytes */
+    CacheShard shards[CACHE_SHARDS];
+};
+
+static char *EntryKey(CacheEntry *e) { return (char*)(e + 1); }
+
+/* FNV-1a; the low bits pick the shard, the rest the bucket. */
+static uint32_t HashKey(const char *key, size_t n) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < n; ++i) {
+        h ^= (unsigned char)key[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static CacheEntry **Bucket(CacheShard *s, uint32_t hash) {
+    return &s->buckets[(hash / CACHE_SHARDS) & (s->nBuckets - 1)];
+}
+
+static void LruUnlink(CacheShard *s, CacheEntry *e) {
+    if (e->newer) e->newer->older = e->older; else s->newest = e->older;
+    if (e->older) e->older->newer = e->newer; else s->oldest = e->newer;
+}
+
+static void LruPushNewest(CacheShard *s, CacheEntry *e) {
+    e->newer = NULL;
+    e->older = s->newest;
+    if (s->newest) s->newest->newer = e; else s->oldest = e;
+    s->newest = e;
+}
+
+static CacheEntry *FindEntry(CacheShard *s, uint32_t hash, const char *key, size_t n) {
+    for (CacheEntry *e = *Bucket(s, hash); e; e = e->chain)
+        if (e->hash == hash && e->keyLen == n && memcmp(EntryKey(e), key, n) == 0)
+            return e;
+    return NULL;
+}
+
+static void RemoveEntry(CacheShard *s, CacheEntry *e) {
+    CacheEntry **pp = Bucket(s, e->hash);
+    while (*pp != e) pp = &(*pp)->chain;
+    *pp = e->chain;
+    LruUnlink(s, e);
+    s->entries--;
+    s->bytes -= e->bytes;
+    free(e);
+}
+
+/* Double the bucket table once the load factor passes 1 (best effort:
+ * on allocation failure the shard keeps its longer chains). */
+static void MaybeGrow(CacheShard *s) {
+    if (s->entries <= s->nBuckets) return;
+    size_t nb = s->nBuckets * 2;
+    CacheEntry **b = (CacheEntry**)calloc(nb, sizeof(CacheEntry*));
+    if (!b) return;
+    for (size_t i = 0; i < s->nBuckets; ++i) {
+        CacheEntry *e = s->buckets[i];
+        while (e) {
+            CacheEntry *next = e->chain;
+            CacheEntry **pp = &b[(e->hash / CACHE_SHARDS) & (nb - 1)];
+            e->chain = *pp;
+            *pp = e;
+            e = next;
+        }
+    }
+    free(s->buckets);
+    s->bytes += (nb - s->nBuckets) * sizeof(CacheEntry*);
+    s->buckets = b;
+    s->nBuckets = nb;
+}
+
+/* Copy the first `max` stored suggestions of `e` into a fresh box. */
+static void CopyOut(const CacheEntry *e, int max, SuggestBox *box) {
+    const char *w = (const char*)(e + 1) + e->keyLen + 1;
+    for (int i = 0; i < e->count && i < max; ++i) {
+        SuggestBoxAdd(box, w);
+        w += strlen(w) + 1;
+    }
+}
+
+static CacheEntry *NewEntry(uint32_t hash, const char *key, size_t n,
+                            int cap, const SuggestBox *box) {
+    size_t bytes = sizeof(CacheEntry) + n + 1;
+    for (int i = 0; i < box->count; ++i) bytes += strlen(box->items[i]) + 1;
+
+    CacheEntry *e = (CacheEntry*)malloc(bytes);
+    if (!e) return NULL;
+    e->chain = e->newer = e->older = NULL;
+    e->hash = hash;
+    e->keyLen = (uint32_t)n;
+    e->cap = cap;
+    e->count = box->count;
+    e->bytes = bytes;
+
+    char *w = EntryKey(e);
+    memcpy(w, key, n);
+    w[n] = '\0';
+    w += n + 1;
+    for (int i = 0; i < box->count; ++i) {
+        size_t len = strlen(box->items[i]) + 1;
+        memcpy(w, box->items[i], len);
+        w += len;
+    }
+    return e;
+}
+
+SuggestCache *SuggestCacheCreate(NonLeafPtr root, size_t maxBytes) {
+    SuggestCache *c = (SuggestCache*)calloc(1, sizeof(*c));
+    if (!c) Error("out of memory: SuggestCacheCreate");
+    c->root = root;
+    c->maxBytes = maxBytes;
+    c->shardBytes = maxBytes / CACHE_SHARDS;
+
+    for (int i = 0; i < CACHE_SHARDS; ++i) {
+        CacheShard *s = &c->shards[i];
+        s->lock = TrieMutexCreate();
+        s->nBuckets = CACHE_MIN_BUCKETS;
+        s->buckets = (CacheEntry**)calloc(s->nBuckets, sizeof(CacheEntry*));
+        if (!s->buckets) Error("out of memory: SuggestCacheCreate");
+        s->bytes = s->nBuckets * sizeof(CacheEntry*);
+    }
+    return c;
+}
+
+void SuggestCacheClear(SuggestCache *cache) {
+    for (int i = 0; i < CACHE_SHARDS; ++i) {
+        CacheShard *s = &cache->shards[i];
+        TrieMutexLock(s->lock);
+        while (s->oldest) RemoveEntry(s, s->oldest);
+        TrieMutexUnlock(s->lock);
+    }
+}
+
+void SuggestCacheDestroy(SuggestCache *cache) {
+    if (!cache) return;
+    SuggestCacheClear(cache);
+    for (int i = 0; i < CACHE_SHARDS; ++i) {
+        free(cache->shards[i].buckets);
+        TrieMutexDestroy(cache->shards[i].lock);
+    }
+    free(cache);
+}
+
+int SuggestCached(SuggestCache *cache, const char *word, size_t len,
+                  int maxSuggestions, SuggestBox *outBox) {
+    SuggestBoxInit(outBox, maxSuggestions);
+
+    /* uppercased, NUL-terminated key */
+    char small[256];
+    char *key = len < sizeof(small) ? small : (char*)malloc(len + 1);
+    if (!key) Error("out of memory: SuggestCached");
+    ScanUpperCopy(key, word, len);
+    key[len] = '\0';
+
+    uint32_t hash = HashKey(key, len);
+    CacheShard *s = &cache->shards[hash % CACHE_SHARDS];
+    int rc = !success;
+
+    TrieMutexLock(s->lock);
+    CacheEntry *e = FindEntry(s, hash, key, len);
+    if (e && (maxSuggestions <= e->cap || e->count < e->cap)) {
+        s->hits++;
+        LruUnlink(s, e);
+        LruPushNewest(s, e);
+        CopyOut(e, maxSuggestions, outBox);
+        TrieMutexUnlock(s->lock);
+        goto done;
+    }
+    s->misses++;
+    TrieMutexUnlock(s->lock);
+
+    if (SearchTrie(cache->root, key) == success) {
+        rc = success;                      /* known words are not cached */
+        goto done;
+    }
+
+    FreeSuggestBox(outBox);
+    SuggestCorrections(cache->root, key, maxSuggestions, outBox);
+
+    e = NewEntry(hash, key, len, maxSuggestions, outBox);
+    if (!e) goto done;                     /* caching is best effort */
+    if (e->bytes + s->nBuckets * sizeof(CacheEntry*) > cache->shardBytes) {
+        free(e);                           /* would not fit even alone */
+        goto done;
+    }
+
+    TrieMutexLock(s->lock);
+    CacheEntry *old = FindEntry(s, hash, key, len);
+    if (old) RemoveEntry(s, old);          /* raced, or computed for a smaller cap */
+    CacheEntry **pp = Bucket(s, hash);
+    e->chain = *pp;
+    *pp = e;
+    LruPushNewest(s, e);
+    s->entries++;
+    s->bytes += e->bytes;
+    MaybeGrow(s);
+    while (s->bytes > cache->shardBytes && s->oldest) {
+        RemoveEntry(s, s->oldest);
+        s->evictions++;
+    }
+    TrieMutexUnlock(s->lock);
+
+done:
+    if (key != small) free(key);
+    return rc;
+}
+
+void SuggestCacheGetStats(SuggestCache *cache, SuggestCacheStats *out) {
+    memset(out, 0, sizeof(*out));
+    out->maxBytes = cache->maxBytes;
+    for (int i = 0; i < CACHE_SHARDS; ++i) {
+        CacheShard *s = &cache->shards[i];
+        TrieMutexLock(s->lock);
+        out->hits      += s->hits;
+        out->misses    += s->misses;
+        out->evictions += s->evictions;
+        out->entries   += s->entries;
+        out->bytes     += s->bytes;
+        TrieMutexUnlock(s->lock);
+    }
+}
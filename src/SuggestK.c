@@ -0,0 +1,177 @@
+#include "TrieNode.h"
+#include "TrieSuggest.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* ================================================================ *
+ * Bounded-k suggestions (Damerau-Levenshtein <= k)                 *
+ *                                                                  *
+ * The trie is walked depth-first carrying one DP row per level:    *
+ * rows[d][j] is the optimal-string-alignment distance between the  *
+ * d-char trie prefix and the first j chars of the input. A child's *
+ * row is computed from its parent's (and grandparent's, for        *
+ * adjacent transpositions), so every prefix is evaluated           *
+ * once and shared by all words below it. Leaf tails are fed        *
+ * through the same recurrence one char at a time.                  *
+ *                                                                  *
+ * A subtree is skipped as soon as the minimum of its row exceeds   *
+ * the bound: every later row (transpositions included) is at least *
+ * that minimum. Depth is capped at m + k for the same reason, and  *
+ * only the diagonal band of width 2k + 1 of each row is computed.  *
+ *                                                                  *
+ * Results are kept best-first: once `maxSuggestions` are held, the *
+ * bound drops below the worst held distance, so the walk only      *
+ * looks for strictly closer words (branch and bound). Ties keep    *
+ * trie order.                                                      *
+ * ================================================================ */
+
+#define K_MAX_WORD 255            /* same prefix limit as SuggestCorrections */
+
+typedef struct {
+    const char *in;               /* input word */
+    int m;                        /* strlen(in) */
+    int k;                        /* requested bound */
+    int bound;                    /* current bound (<= k) */
+    int *rows;                    /* (m + k + 1) rows of m + 1 cells */
+    char prefix[K_MAX_WORD + 1];  /* trie chars above the current row */
+    int cap;
+    SuggestBox *box;
+    int *dist;                    /* distance of box->items[i] */
+} KSearch;
+
+#define ROW(s, d) ((s)->rows + (size_t)(d) * (size_t)((s)->m + 1))
+
+/* Compute row d + 1 for trie char `ch` at depth d; returns its minimum.
+ * Only the band |j - (d + 1)| <= bound is evaluated: cells outside it
+ * exceed the bound anyway and read as k + 1, so every value <= bound in
+ * the band is exact. Work per node is O(k) instead of O(m). */
+static int NextRow(KSearch *s, int d, char ch) {
+    const int *prev = ROW(s, d);
+    const int *prev2 = d > 0 ? ROW(s, d - 1) : NULL;
+    int *row = ROW(s, d + 1);
+    const char *in = s->in;
+    const int far = s->k + 1;
+    int lo = d + 1 - s->bound, hi = d + 1 + s->bound;
+    if (lo < 1) lo = 1;
+    if (hi > s->m) hi = s->m;
+
+    s->prefix[d] = ch;
+    row[0] = d + 1;
+    if (lo > hi)                                          /* no input column in the band: */
+        return row[0] <= s->bound ? row[0] : far;         /* empty input, or too deep */
+    if (lo > 1) row[lo - 1] = far;
+    if (hi < s->m) row[hi + 1] = far;
+
+    int best = lo == 1 ? row[0] : far;
+    for (int j = lo; j <= hi; ++j) {
+        int v = prev[j - 1] + (in[j - 1] != ch);          /* match / substitution */
+        if (prev[j] + 1 < v) v = prev[j] + 1;             /* extra trie char */
+        if (row[j - 1] + 1 < v) v = row[j - 1] + 1;       /* extra input char */
+        if (prev2 && j > 1 && in[j - 1] == s->prefix[d - 1] && in[j - 2] == ch &&
+            prev2[j - 2] + 1 < v)
+            v = prev2[j - 2] + 1;                         /* transposition */
+        row[j] = v;
+        if (v < best) best = v;
+    }
+    return best;
+}
+
+/* Distance of the word ending at depth d, or k + 1 if it is out of band. */
+static int FinalDistance(const KSearch *s, int d) {
+    if (d - s->m > s->bound || s->m - d > s->bound) return s->k + 1;
+    return ROW(s, d)[s->m];
+}
+
+/* Record prefix[0..len) at distance `d`, keeping the `cap` closest. */
+static void Emit(KSearch *s, int len, int d) {
+    SuggestBox *box = s->box;
+
+    if (box->count == s->cap) {
+        /* evict the last of the farthest entries; `d` is strictly closer */
+        int worst = 0;
+        for (int i = 1; i < box->count; ++i)
+            if (s->dist[i] >= s->dist[worst]) worst = i;
+        free(box->items[worst]);
+        memmove(box->items + worst, box->items + worst + 1,
+                (size_t)(box->count - worst - 1) * sizeof(char*));
+        memmove(s->dist + worst, s->dist + worst + 1,
+                (size_t)(box->count - worst - 1) * sizeof(int));
+        box->count--;
+    }
+
+    char *w = (char*)malloc((size_t)len + 1);
+    if (!w) return;
+    memcpy(w, s->prefix, (size_t)len);
+    w[len] = '\0';
+    s->dist[box->count] = d;
+    box->items[box->count++] = w;
+
+    if (box->count == s->cap) {
+        int worst = 0;
+        for (int i = 0; i < box->count; ++i)
+            if (s->dist[i] > worst) worst = s->dist[i];
+        s->bound = worst - 1;
+    }
+}
+
+static void dfsK(KSearch *s, NonLeafPtr p, int d) {
+    for (int e = 0; e < (int)p->count; ++e) {
+        if (s->bound < 0 || d + 1 > s->m + s->k) return;
+        if (NextRow(s, d, p->letters[e]) > s->bound) continue;
+
+        NonLeafPtr child = p->ptrs[e];
+        if (child->kind == leaf) {
+            /* run the tail through the same recurrence */
+            const char *t = ((LeafPtr)child)->word;
+            int dd = d + 1, ok = 1;
+            for (; *t; ++t, ++dd) {
+                if (dd + 1 > s->m + s->k || NextRow(s, dd, *t) > s->bound) { ok = 0; break; }
+            }
+            if (ok && FinalDistance(s, dd) <= s->bound) Emit(s, dd, FinalDistance(s, dd));
+        } else {
+            if (child->EndOfWord == yes && FinalDistance(s, d + 1) <= s->bound)
+                Emit(s, d + 1, FinalDistance(s, d + 1));
+            dfsK(s, child, d + 1);
+        }
+    }
+}
+
+void SuggestCorrectionsK(NonLeafPtr root, const char *upper_word, int k,
+                         int maxSuggestions, SuggestBox *outBox) {
+    if (!SuggestBoxInit(outBox, maxSuggestions)) return;
+    int m = (int)strlen(upper_word);
+    if (maxSuggestions <= 0 || k < 0 || m + k > K_MAX_WORD) return;
+
+    KSearch *s = (KSearch*)malloc(sizeof(KSearch));
+    int *rows = (int*)malloc((size_t)(m + k + 1) * (size_t)(m + 1) * sizeof(int));
+    int *dist = (int*)malloc((size_t)maxSuggestions * sizeof(int));
+    if (!s || !rows || !dist) Error("out of memory: SuggestCorrectionsK");
+
+    s->in = upper_word;
+    s->m = m;
+    s->k = s->bound = k;
+    s->rows = rows;
+    s->cap = maxSuggestions;
+    s->box = outBox;
+    s->dist = dist;
+    for (int j = 0; j <= m; ++j) rows[j] = j;
+
+    /* the empty word (root EndOfWord) never occurs: words are non-empty */
+    dfsK(s, root, 0);
+
+    /* stable sort by distance (insertion sort; the box is small) */
+    for (int i = 1; i < outBox->count; ++i) {
+        char *w = outBox->items[i];
+        int dv = dist[i], j = i;
+        for (; j > 0 && dist[j - 1] > dv; --j) {
+            outBox->items[j] = outBox->items[j - 1];
+            dist[j] = dist[j - 1];
+        }
+        outBox->items[j] = w;
+        dist[j] = dv;
+    }
+
+    free(dist);
+    free(rows);
+    free(s);
+}
@@ -0,0 +1,88 @@
+#include "TrieNode.h"
+#include "TrieSuggest.h"
+#include <string.h>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+/* ================================================================ *
+ * Suggestion limits and pre-filters                                *
+ *                                                                  *
+ * A one-edit search for a token no dictionary word is close to     *
+ * (a URL, a base64 run) still tries every edit at every node       *
+ * before it gives up, so these searches set the tail latency.      *
+ * SuggestCorrectionsWithOptions bounds them two ways:              *
+ *                                                                  *
+ *  - pre-filters, from one walk of the dictionary: one edit moves  *
+ *    the length by at most 1 and replaces or drops at most one     *
+ *    byte, so a token outside minLen - 1 .. maxLen + 1, or with    *
+ *    two bytes that no word uses, has no suggestions at all;       *
+ *  - a budget charged per node entered by the DFS: a node count    *
+ *    and a monotonic-clock deadline, read only every               *
+ *    BUDGET_CLOCK_EVERY nodes to keep the clock off the hot path.  *
+ * ================================================================ */
+
+unsigned long long TrieNowNs(void) {
+#if defined(_WIN32)
+    static LARGE_INTEGER freq;
+    LARGE_INTEGER t;
+    if (!freq.QuadPart) QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&t);
+    return (unsigned long long)((double)t.QuadPart * 1e9 / (double)freq.QuadPart);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ull + (unsigned long long)ts.tv_nsec;
+#endif
+}
+
+static void AddByte(unsigned char *set, unsigned char c) {
+    set[c >> 3] |= (unsigned char)(1u << (c & 7));
+}
+
+static int HasByte(const unsigned char *set, unsigned char c) {
+    return (set[c >> 3] >> (c & 7)) & 1;
+}
+
+static void NoteLength(SuggestOptions *o, size_t len) {
+    if (len < o->minLen) o->minLen = len;
+    if (len > o->maxLen) o->maxLen = len;
+}
+
+static void ProfileWords(SuggestOptions *o, NonLeafPtr p, size_t depth) {
+    if (p->kind == leaf) {
+        const char *w = ((LeafPtr)p)->word;
+        size_t n = strlen(w);
+        for (size_t i = 0; i < n; ++i) AddByte(o->alphabet, (unsigned char)w[i]);
+        NoteLength(o, depth + n);
+        return;
+    }
+    if (p->EndOfWord == yes) NoteLength(o, depth);
+    for (int i = 0; i < (int)p->count; ++i) {
+        if (!p->ptrs[i]) continue;
+        AddByte(o->alphabet, (unsigned char)p->letters[i]);
+        ProfileWords(o, p->ptrs[i], depth + 1);
+    }
+}
+
+void SuggestOptionsInit(SuggestOptions *opts, NonLeafPtr root) {
+    memset(opts, 0, sizeof(*opts));
+    if (!root) return;
+
+    opts->prefilter = 1;
+    opts->minLen = (size_t)-1;                    /* stays above maxLen if there are no words */
+    ProfileWords(opts, root, 0);
+}
+
+int SuggestPrefilterRejects(const SuggestOptions *opts, const char *word) {
+    size_t len = 0;
+    int foreign = 0;
+
+    for (; word[len]; ++len)
+        if (!HasByte(opts->alphabet, (unsigned char)word[len]) && ++foreign > 1) return 1;
+    return len + 1 < opts->minLen || len > opts->maxLen + 1;
+}
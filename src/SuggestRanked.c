@@ -0,0 +1,208 @@
+#include "TrieNode.h"
+#include "TrieSuggest.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* ================================================================ *
+ * Ranked one-edit suggestions (branch and bound)                   *
+ *                                                                  *
+ * Same candidate set as dfsSuggest (Damerau-Levenshtein <= 1), but *
+ * instead of stopping at the first `maxSuggestions` hits the walk  *
+ * keeps the best ones in a min-heap of size k:                     *
+ *                                                                  *
+ *   score = (weight + 1) * EditFactor[edit kind]                   *
+ *                                                                  *
+ * Before entering a subtree, its best possible score is bounded by *
+ * (maxWeight + 1) * factor, where the factor is that of the edit   *
+ * already spent (or of an exact match if none was). Once the heap  *
+ * is full, subtrees that cannot beat its minimum are skipped, so   *
+ * frequent words are found early and rare branches are cut.        *
+ * ================================================================ */
+
+#define RANK_MAX_WORD 256
+
+/* Indexed by edit kind: exact, substitution, insertion, deletion,
+ * transposition. Transposed and dropped/doubled letters are the common
+ * typing slips, so they rank above a substituted letter. */
+static const unsigned int EditFactor[] = { 16, 4, 5, 5, 8 };
+
+typedef struct {
+    char *word;
+    unsigned long long score;
+    unsigned int seq;             /* discovery order, breaks ties */
+} RankItem;
+
+typedef struct {
+    const char *in;
+    char prefix[RANK_MAX_WORD];
+    char word[RANK_MAX_WORD];     /* prefix + leaf tail of a candidate */
+    RankItem *heap;               /* min-heap: the weakest kept item on top */
+    int count, cap;
+    unsigned int seq;
+} RankSearch;
+
+static unsigned long long Score(unsigned int weight, int kind) {
+    return ((unsigned long long)weight + 1u) * EditFactor[kind];
+}
+
+/* a ranks below b */
+static int Weaker(const RankItem *a, const RankItem *b) {
+    return a->score < b->score || (a->score == b->score && a->seq > b->seq);
+}
+
+static void SiftUp(RankItem *h, int i) {
+    while (i > 0) {
+        int up = (i - 1) / 2;
+        if (!Weaker(&h[i], &h[up])) break;
+        RankItem t = h[i]; h[i] = h[up]; h[up] = t;
+        i = up;
+    }
+}
+
+static void SiftDown(RankItem *h, int n, int i) {
+    while (1) {
+        int l = 2 * i + 1, r = l + 1, m = i;
+        if (l < n && Weaker(&h[l], &h[m])) m = l;
+        if (r < n && Weaker(&h[r], &h[m])) m = r;
+        if (m == i) return;
+        RankItem t = h[i]; h[i] = h[m]; h[m] = t;
+        i = m;
+    }
+}
+
+/* Could a candidate scoring `bound` still enter the heap? */
+static int CanBeat(const RankSearch *s, unsigned long long bound) {
+    return s->count < s->cap || bound > s->heap[0].score;
+}
+
+static void Offer(RankSearch *s, const char *w, unsigned long long score) {
+    if (!CanBeat(s, score)) return;
+
+    /* the same word may be reached by several edits: keep its best score */
+    for (int i = 0; i < s->count; ++i)
+        if (strcmp(s->heap[i].word, w) == 0) {
+            if (score > s->heap[i].score) {
+                s->heap[i].score = score;
+                SiftDown(s->heap, s->count, i);
+            }
+            return;
+        }
+
+    size_t n = strlen(w);
+    char *copy = (char*)malloc(n + 1);
+    if (!copy) return;
+    memcpy(copy, w, n + 1);
+
+    if (s->count < s->cap) {
+        RankItem *it = &s->heap[s->count];
+        it->word = copy; it->score = score; it->seq = s->seq++;
+        SiftUp(s->heap, s->count++);
+    } else {
+        free(s->heap[0].word);
+        s->heap[0].word = copy; s->heap[0].score = score; s->heap[0].seq = s->seq++;
+        SiftDown(s->heap, s->count, 0);
+    }
+}
+
+/* Offer prefix[0..plen) + tail with the given weight and edit kind. */
+static void OfferLeafWord(RankSearch *s, int plen, const char *tail,
+                          unsigned int weight, int kind) {
+    unsigned long long score = Score(weight, kind);
+    size_t lt = strlen(tail);
+    if (!CanBeat(s, score) || (size_t)plen + lt >= RANK_MAX_WORD) return;
+    memcpy(s->word, s->prefix, (size_t)plen);
+    memcpy(s->word + plen, tail, lt + 1);
+    Offer(s, s->word, score);
+}
+
+static void dfsRanked(RankSearch *s, NonLeafPtr p, int idx, int plen, int kind);
+
+/* Continue into `child` with input position idx and prefix length plen. */
+static void Descend(RankSearch *s, NonLeafPtr child, int idx, int plen, int kind) {
+    if (child->kind == leaf) {
+        LeafPtr lf = (LeafPtr)child;
+        int k = TailEditKind(lf->word, s->in + idx, kind != editNone);
+        if (k == notFound) return;
+        OfferLeafWord(s, plen, lf->word, lf->weight, kind != editNone ? kind : k);
+    } else {
+        dfsRanked(s, child, idx, plen, kind);
+    }
+}
+
+static void dfsRanked(RankSearch *s, NonLeafPtr p, int idx, int plen, int kind) {
+    const char *in = s->in;
+
+    /* the factor of an exact match is the largest, so this bounds every
+       candidate below p whether or not the edit is still unspent */
+    if (!CanBeat(s, Score(p->maxWeight, kind)) || plen + 2 >= RANK_MAX_WORD) return;
+
+    if (in[idx] == '\0' && p->EndOfWord == yes) {
+        s->prefix[plen] = '\0';
+        Offer(s, s->prefix, Score(p->weight, kind));
+    }
+
+    /* insertion (extra input char): consume in[idx] and stay on this node */
+    if (kind == editNone && in[idx] != '\0')
+        dfsRanked(s, p, idx + 1, plen, editInsertion);
+
+    for (int i = 0; i < (int)p->count; ++i) {
+        char edge = p->letters[i];
+        NonLeafPtr child = p->ptrs[i];
+        s->prefix[plen] = edge;
+
+        if (in[idx] != '\0' && in[idx] == edge)
+            Descend(s, child, idx + 1, plen + 1, kind);                 /* exact */
+        if (kind == editNone && in[idx] != '\0' && in[idx] != edge)
+            Descend(s, child, idx + 1, plen + 1, editSubstitution);
+        if (kind == editNone)
+            Descend(s, child, idx, plen + 1, editDeletion);             /* missing input char */
+    }
+
+    /* adjacent transposition: consume in[idx+1] first, then in[idx] */
+    if (kind == editNone && in[idx] != '\0' && in[idx + 1] != '\0') {
+        int pos1 = Position(p, in[idx + 1]);
+        if (pos1 == notFound || !p->ptrs[pos1]) return;
+        NonLeafPtr c1 = p->ptrs[pos1];
+        s->prefix[plen] = in[idx + 1];
+
+        if (c1->kind == leaf) {
+            LeafPtr lf1 = (LeafPtr)c1;
+            if (lf1->word[0] == in[idx] && strcmp(lf1->word + 1, in + idx + 2) == 0)
+                OfferLeafWord(s, plen + 1, lf1->word, lf1->weight, editTransposition);
+            return;
+        }
+
+        int pos2 = Position(c1, in[idx]);
+        if (pos2 == notFound || !c1->ptrs[pos2]) return;
+        s->prefix[plen + 1] = in[idx];
+        Descend(s, c1->ptrs[pos2], idx + 2, plen + 2, editTransposition);
+    }
+}
+
+void SuggestCorrectionsRanked(NonLeafPtr root, const char *upper_word,
+                              int maxSuggestions, SuggestBox *outBox) {
+    if (!SuggestBoxInit(outBox, maxSuggestions)) return;
+    if (maxSuggestions <= 0 || strlen(upper_word) + 2 >= RANK_MAX_WORD) return;
+
+    RankSearch *s = (RankSearch*)malloc(sizeof(RankSearch));
+    RankItem *heap = (RankItem*)malloc((size_t)maxSuggestions * sizeof(RankItem));
+    if (!s || !heap) Error("out of memory: SuggestCorrectionsRanked");
+    s->in = upper_word;
+    s->heap = heap;
+    s->count = 0;
+    s->cap = maxSuggestions;
+    s->seq = 0;
+
+    dfsRanked(s, root, 0, 0, editNone);
+
+    /* pop weakest first, fill the box from the back: best first */
+    outBox->count = s->count;
+    while (s->count > 0) {
+        outBox->items[s->count - 1] = heap[0].word;
+        heap[0] = heap[--s->count];
+        SiftDown(heap, s->count, 0);
+    }
+
+    free(heap);
+    free(s);
+}
@@ -0,0 +1,115 @@
+#include "SimpleTrieSpellChecker.h"
+#include "TrieSuggest.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ================================================================ *
+ * Reusable suggestion output                                       *
+ *                                                                  *
+ * A SuggestResult keeps three buffers that only ever grow:         *
+ *  - buf:     the words, NUL-terminated, back to back,             *
+ *  - offsets: where each word starts in buf,                       *
+ *  - slots:   an open-addressing (linear probing) hash set of word *
+ *             indices, kept at most half full.                     *
+ * A candidate is appended to buf in place (prefix + leaf tail, no  *
+ * temporary), looked up in the set, and rolled back if it is a     *
+ * duplicate. Resetting for the next search clears the slots only.  *
+ * ================================================================ */
+
+void SuggestResultInit(SuggestResult *r) {
+    memset(r, 0, sizeof(*r));
+}
+
+void SuggestResultFree(SuggestResult *r) {
+    if (!r) return;
+    free(r->buf);
+    free(r->offsets);
+    free(r->slots);
+    SuggestResultInit(r);
+}
+
+void ResultReset(SuggestResult *r, int maxSuggestions) {
+    r->count = 0;
+    r->used = 0;
+    r->cap = maxSuggestions < 0 ? 0 : maxSuggestions;
+    r->truncated = 0;
+    if (r->slots) memset(r->slots, 0, ((size_t)r->slotMask + 1) * sizeof(unsigned int));
+}
+
+static uint32_t HashWord(const char *w) {
+    uint32_t h = 2166136261u;                     /* FNV-1a */
+    for (; *w; ++w) {
+        h ^= (unsigned char)*w;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+/* Make room for one more word: offsets, bytes, and a hash set kept at
+ * most half full (it is sized by the words held, not by the cap). */
+static void Reserve(SuggestResult *r, size_t bytes) {
+    if (r->count == r->offsetsCap) {
+        int n = r->offsetsCap ? r->offsetsCap * 2 : 16;
+        size_t *o = (size_t*)realloc(r->offsets, (size_t)n * sizeof(size_t));
+        if (!o) Error("out of memory: SuggestResult");
+        r->offsets = o;
+        r->offsetsCap = n;
+    }
+
+    if (r->used + bytes > r->bufCap) {
+        size_t cap = r->bufCap ? r->bufCap : 256;
+        while (cap < r->used + bytes) cap *= 2;
+        char *b = (char*)realloc(r->buf, cap);
+        if (!b) Error("out of memory: SuggestResult");
+        r->buf = b;
+        r->bufCap = cap;
+    }
+
+    size_t slots = r->slots ? (size_t)r->slotMask + 1 : 0;
+    if (2 * ((size_t)r->count + 1) > slots) {
+        size_t n = slots ? slots * 2 : 32;
+        unsigned int *t = (unsigned int*)calloc(n, sizeof(unsigned int));
+        if (!t) Error("out of memory: SuggestResult");
+        for (int i = 0; i < r->count; ++i) {
+            unsigned int j = HashWord(r->buf + r->offsets[i]) & (unsigned int)(n - 1);
+            while (t[j]) j = (j + 1) & (unsigned int)(n - 1);
+            t[j] = (unsigned int)i + 1;
+        }
+        free(r->slots);
+        r->slots = t;
+        r->slotMask = (unsigned int)(n - 1);
+    }
+}
+
+void ResultAddWord(SuggestResult *r, const char *prefix, const char *tail) {
+    if (r->count >= r->cap) return;
+
+    size_t lp = strlen(prefix), lt = strlen(tail);
+    Reserve(r, lp + lt + 1);
+    char *w = r->buf + r->used;
+    memcpy(w, prefix, lp);
+    memcpy(w + lp, tail, lt + 1);
+
+    unsigned int i = HashWord(w) & r->slotMask;
+    while (r->slots[i]) {
+        if (strcmp(r->buf + r->offsets[r->slots[i] - 1], w) == 0)
+            return;                               /* duplicate: leave `used` as is */
+        i = (i + 1) & r->slotMask;
+    }
+
+    r->slots[i] = (unsigned int)r->count + 1;
+    r->offsets[r->count++] = r->used;
+    r->used += lp + lt + 1;
+}
+
+void ResultToBox(const SuggestResult *r, SuggestBox *box) {
+    for (int i = 0; i < r->count && box->count < box->cap; ++i) {
+        const char *w = r->buf + r->offsets[i];
+        size_t n = strlen(w) + 1;
+        char *copy = (char*)malloc(n);
+        if (!copy) return;
+        memcpy(copy, w, n);
+        box->items[box->count++] = copy;
+    }
+}
@@ -0,0 +1,349 @@
+#include "TextScan.h"
+#include "TriePlatform.h"
+#include "SimpleTrieSpellChecker.h"
+#include <string.h>
+
+/* ================================================================ *
+ * Block scanner                                                    *
+ *                                                                  *
+ * The input is classified 64 bytes at a time into bit masks: ASCII *
+ * letters, '\n' and bytes >= 0x80. Tokens are then the runs of set *
+ * bits in the letter mask, found with count-trailing-zeros, and    *
+ * the line count advances by the popcount of the newline bits      *
+ * passed on the way; no byte is examined one at a time.            *
+ *                                                                  *
+ * The masks come from AVX2 (2 x 32 bytes), SSE2 (4 x 16) or a      *
+ * scalar loop, picked once at run time (SpellCheckScanner). The    *
+ * same compares fold a-z to A-Z for the suggestion paths.          *
+ *                                                                  *
+ * A block holding a byte >= 0x80 (rare in English text, and every  *
+ * such block costs one extra pass) takes the UTF-8 slow path: each *
+ * sequence is decoded and its bytes join the letter mask if the    *
+ * code point is a letter; a sequence running into the next block   *
+ * carries its class over. Malformed bytes are separators.          *
+ * ================================================================ */
+
+#define SCAN_BLOCK 64
+
+typedef struct {
+    uint64_t word;                /* token bytes (ASCII letters until the UTF-8 pass) */
+    uint64_t newline;
+    uint64_t high;                /* bytes >= 0x80 */
+} BlockMasks;
+
+typedef void (*MaskFn)(const char *p, BlockMasks *m);
+typedef void (*UpperFn)(char *dst, const char *src, size_t n);
+
+static uint64_t Above(unsigned i) { return i >= 64 ? 0 : ~(uint64_t)0 << i; }
+
+/* ========================= *
+ * Scalar                    *
+ * ========================= */
+
+static void MasksScalar(const char *p, BlockMasks *m) {
+    uint64_t w = 0, nl = 0, hi = 0;
+    for (unsigned i = 0; i < SCAN_BLOCK; ++i) {
+        unsigned char c = (unsigned char)p[i];
+        w  |= (uint64_t)((unsigned char)((c | 0x20) - 'a') < 26u) << i;
+        nl |= (uint64_t)(c == '\n') << i;
+        hi |= (uint64_t)(c >> 7) << i;
+    }
+    m->word = w;
+    m->newline = nl;
+    m->high = hi;
+}
+
+static void UpperScalar(char *dst, const char *src, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        char c = src[i];
+        dst[i] = (unsigned char)(c - 'a') < 26u ? (char)(c - ('a' - 'A')) : c;
+    }
+}
+
+/* ========================= *
+ * SSE2                      *
+ * ========================= *
+ * SSE2 has no unsigned byte compare; x in [lo, lo+26) is tested as  *
+ * (x - lo - 128) < -128 + 26, signed, which wraps everything else   *
+ * above the bound.                                                  */
+
+#if TRIE_HAVE_SSE2
+static void MasksSSE2(const char *p, BlockMasks *m) {
+    const __m128i lo = _mm_set1_epi8((char)('a' + 128));
+    const __m128i bound = _mm_set1_epi8((char)(-128 + 26));
+    const __m128i case20 = _mm_set1_epi8(0x20);
+    const __m128i nlByte = _mm_set1_epi8('\n');
+    uint64_t w = 0, nl = 0, hi = 0;
+
+    for (unsigned k = 0; k < SCAN_BLOCK; k += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(p + k));
+        __m128i letter = _mm_cmplt_epi8(_mm_sub_epi8(_mm_or_si128(v, case20), lo), bound);
+        w  |= (uint64_t)(unsigned)_mm_movemask_epi8(letter) << k;
+        nl |= (uint64_t)(unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(v, nlByte)) << k;
+        hi |= (uint64_t)(unsigned)_mm_movemask_epi8(v) << k;
+    }
+    m->word = w;
+    m->newline = nl;
+    m->high = hi;
+}
+
+static void UpperSSE2(char *dst, const char *src, size_t n) {
+    const __m128i lo = _mm_set1_epi8((char)('a' + 128));
+    const __m128i bound = _mm_set1_epi8((char)(-128 + 26));
+    const __m128i case20 = _mm_set1_epi8(0x20);
+    size_t i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i lower = _mm_cmplt_epi8(_mm_sub_epi8(v, lo), bound);
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_sub_epi8(v, _mm_and_si128(lower, case20)));
+    }
+    UpperScalar(dst + i, src + i, n - i);
+}
+#endif
+
+/* ========================= *
+ * AVX2                      *
+ * ========================= */
+
+#if TRIE_CAN_AVX2
+TRIE_TARGET_AVX2
+static void MasksAVX2(const char *p, BlockMasks *m) {
+    const __m256i lo = _mm256_set1_epi8((char)('a' + 128));
+    const __m256i bound = _mm256_set1_epi8((char)(-128 + 26));
+    const __m256i case20 = _mm256_set1_epi8(0x20);
+    const __m256i nlByte = _mm256_set1_epi8('\n');
+    uint64_t w = 0, nl = 0, hi = 0;
+
+    for (unsigned k = 0; k < SCAN_BLOCK; k += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(p + k));
+        /* cmpgt(bound, x) == x < bound */
+        __m256i letter = _mm256_cmpgt_epi8(bound, _mm256_sub_epi8(_mm256_or_si256(v, case20), lo));
+        w  |= (uint64_t)(uint32_t)_mm256_movemask_epi8(letter) << k;
+        nl |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, nlByte)) << k;
+        hi |= (uint64_t)(uint32_t)_mm256_movemask_epi8(v) << k;
+    }
+    m->word = w;
+    m->newline = nl;
+    m->high = hi;
+}
+
+TRIE_TARGET_AVX2
+static void UpperAVX2(char *dst, const char *src, size_t n) {
+    const __m256i lo = _mm256_set1_epi8((char)('a' + 128));
+    const __m256i bound = _mm256_set1_epi8((char)(-128 + 26));
+    const __m256i case20 = _mm256_set1_epi8(0x20);
+    size_t i = 0;
+
+    for (; i + 32 <= n; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(src + i));
+        __m256i lower = _mm256_cmpgt_epi8(bound, _mm256_sub_epi8(v, lo));
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_sub_epi8(v, _mm256_and_si256(lower, case20)));
+    }
+    UpperScalar(dst + i, src + i, n - i);
+}
+#endif
+
+/* ========================= *
+ * Dispatch                  *
+ * ========================= */
+
+static volatile long scanLevel;   /* scanAuto until the first scan or selection */
+
+static int BestLevel(void) {
+#if TRIE_CAN_AVX2
+    if (TrieCpuHasAvx2()) return scanAVX2;
+#endif
+#if TRIE_HAVE_SSE2
+    return scanSSE2;
+#else
+    return scanScalar;
+#endif
+}
+
+static int CurrentLevel(void) {
+    long level = TrieAtomicLoad(&scanLevel);
+    if (level == scanAuto) {
+        level = BestLevel();
+        TrieAtomicStore(&scanLevel, level);
+    }
+    return (int)level;
+}
+
+int SpellCheckScanner(int level) {
+    int best = BestLevel();
+    if (level == scanAuto || level > best) level = best;
+    if (level < scanScalar) level = scanScalar;
+    TrieAtomicStore(&scanLevel, level);
+    return level;
+}
+
+static MaskFn PickMasks(void) {
+    switch (CurrentLevel()) {
+#if TRIE_CAN_AVX2
+    case scanAVX2: return MasksAVX2;
+#endif
+#if TRIE_HAVE_SSE2
+    case scanSSE2: return MasksSSE2;
+#endif
+    default:       return MasksScalar;
+    }
+}
+
+static UpperFn PickUpper(void) {
+    switch (CurrentLevel()) {
+#if TRIE_CAN_AVX2
+    case scanAVX2: return UpperAVX2;
+#endif
+#if TRIE_HAVE_SSE2
+    case scanSSE2: return UpperSSE2;
+#endif
+    default:       return UpperScalar;
+    }
+}
+
+void ScanUpperCopy(char *dst, const char *src, size_t n) {
+    if (n < 16) UpperScalar(dst, src, n);
+    else        PickUpper()(dst, src, n);
+}
+
+/* ========================= *
+ * UTF-8 slow path           *
+ * ========================= *
+ * Letters outside ASCII: the letter blocks of Latin-1 and Latin     *
+ * Extended, combining diacritics, Greek, Cyrillic, Armenian, Hebrew *
+ * and Arabic letters, Devanagari, Latin/Greek Extended Additional,  *
+ * kana, CJK ideographs and Hangul syllables. Punctuation such as    *
+ * U+2019 (right quote) or U+2014 (em dash) separates tokens, like   *
+ * their ASCII counterparts.                                         */
+
+static const uint32_t letterRanges[][2] = {
+    { 0x00AA, 0x00AA }, { 0x00B5, 0x00B5 }, { 0x00BA, 0x00BA },
+    { 0x00C0, 0x00D6 }, { 0x00D8, 0x00F6 }, { 0x00F8, 0x02AF },
+    { 0x0300, 0x036F }, { 0x0370, 0x037D }, { 0x0386, 0x0386 },
+    { 0x0388, 0x03FF }, { 0x0400, 0x0481 }, { 0x0483, 0x052F },
+    { 0x0531, 0x0556 }, { 0x0561, 0x0587 }, { 0x05D0, 0x05EA },
+    { 0x0620, 0x064A }, { 0x0900, 0x0963 }, { 0x0966, 0x097F },
+    { 0x1E00, 0x1FFF }, { 0x3041, 0x3096 }, { 0x30A1, 0x30FA },
+    { 0x4E00, 0x9FFF }, { 0xAC00, 0xD7A3 }
+};
+
+static int IsLetterCodePoint(uint32_t cp) {
+    int lo = 0, hi = (int)(sizeof(letterRanges) / sizeof(letterRanges[0])) - 1;
+    while (lo <= hi) {
+        int mid = (lo + hi) >> 1;
+        if (cp < letterRanges[mid][0])      hi = mid - 1;
+        else if (cp > letterRanges[mid][1]) lo = mid + 1;
+        else return 1;
+    }
+    return 0;
+}
+
+/* Decode the sequence at p[0..avail) (p[0] >= 0x80): its length in *n
+ * (1 for a malformed byte) and whether it is a letter. */
+static int Utf8Letter(const unsigned char *p, size_t avail, unsigned *n) {
+    unsigned c = p[0], len;
+    uint32_t cp;
+    unsigned char min = 0x80, max = 0xBF;   /* range of the second byte */
+
+    *n = 1;
+    if (c >= 0xC2 && c <= 0xDF)      { len = 2; cp = c & 0x1F; }
+    else if (c >= 0xE0 && c <= 0xEF) { len = 3; cp = c & 0x0F;
+                                       if (c == 0xE0) min = 0xA0;    /* overlong */
+                                       if (c == 0xED) max = 0x9F; }  /* surrogates */
+    else if (c >= 0xF0 && c <= 0xF4) { len = 4; cp = c & 0x07;
+                                       if (c == 0xF0) min = 0x90;
+                                       if (c == 0xF4) max = 0x8F; }  /* > U+10FFFF */
+    else return 0;
+
+    if (avail < len || p[1] < min || p[1] > max) return 0;
+    for (unsigned i = 1; i < len; ++i) {
+        if ((p[i] & 0xC0) != 0x80) return 0;
+        cp = (cp << 6) | (p[i] & 0x3Fu);
+    }
+    *n = len;
+    return IsLetterCodePoint(cp);
+}
+
+/* Letter mask of block b with its non-ASCII bytes classified. *carry is
+ * the number of leading bytes still belonging to a sequence of the
+ * previous block, *carryWord its class. */
+static uint64_t Utf8WordMask(const char *buf, size_t len, size_t b, const BlockMasks *m,
+                             unsigned *carry, int *carryWord) {
+    uint64_t w = m->word;
+    unsigned i = 0;
+
+    if (*carry) {
+        i = *carry < SCAN_BLOCK ? *carry : SCAN_BLOCK;
+        uint64_t lead = ~Above(i);
+        w = *carryWord ? (w | lead) : (w & ~lead);
+        *carry -= i;
+    }
+
+    uint64_t h = m->high & Above(i);
+    while (h) {
+        unsigned j = (unsigned)TrieCtz64(h), n;
+        int letter = Utf8Letter((const unsigned char*)buf + b + j, len - (b + j), &n);
+        unsigned end = j + n;
+        if (end > SCAN_BLOCK) {
+            *carry = end - SCAN_BLOCK;
+            *carryWord = letter;
+            end = SCAN_BLOCK;
+        }
+        if (letter) w |= Above(j) & ~Above(end);
+        h &= Above(end);
+    }
+    return w;
+}
+
+/* ========================= *
+ * Tokens                    *
+ * ========================= */
+
+void ScanText(const char *buf, size_t len, size_t *line, ScanTokenFn fn, void *ctx) {
+    MaskFn masks = PickMasks();
+    char pad[SCAN_BLOCK];
+    unsigned carry = 0;
+    int carryWord = 0, inToken = 0;
+    size_t tokStart = 0;
+
+    for (size_t b = 0; b < len; b += SCAN_BLOCK) {
+        BlockMasks m;
+        if (len - b >= SCAN_BLOCK) {
+            masks(buf + b, &m);
+        } else {                                  /* zero padding: no letters, no newlines */
+            memset(pad, 0, sizeof(pad));
+            memcpy(pad, buf + b, len - b);
+            masks(pad, &m);
+        }
+        if (m.high || carry) m.word = Utf8WordMask(buf, len, b, &m, &carry, &carryWord);
+
+        unsigned cur = 0;                         /* bits below cur are done */
+        while (1) {
+            if (!inToken) {
+                uint64_t rest = m.word & Above(cur);
+                if (!rest) {
+                    *line += (size_t)TriePopcount64(m.newline & Above(cur));
+                    break;
+                }
+                unsigned s = (unsigned)TrieCtz64(rest);
+                *line += (size_t)TriePopcount64(m.newline & Above(cur) & ~Above(s));
+                tokStart = b + s;
+                inToken = 1;
+                cur = s;
+            }
+            uint64_t ends = ~m.word & Above(cur);
+            if (!ends) break;                     /* the token goes on in the next block */
+            unsigned e = (unsigned)TrieCtz64(ends);
+            fn(ctx, tokStart, b + e - tokStart, *line);
+            inToken = 0;
+            cur = e;
+        }
+    }
+    if (inToken) fn(ctx, tokStart, len - tokStart, *line);
+}
+
+size_t ScanSafeEnd(const char *buf, size_t len) {
+    while (len > 0 && !ScanIsSeparator(buf[len - 1])) --len;
+    return len;
+}
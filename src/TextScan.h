@@ -0,0 +1,35 @@
+#pragma once
+#include <stddef.h>
+
+/* ================================================================ *
+ * Text scanning for the SpellCheck* functions (library-private)    *
+ *                                                                  *
+ * A token is a maximal run of letters: ASCII A-Z / a-z and, in     *
+ * valid UTF-8, code points of the alphabetic scripts (see          *
+ * TextScan.c). Everything else - ASCII punctuation, digits and     *
+ * spaces, non-letter code points, malformed bytes - separates      *
+ * tokens. Offsets and lengths are in bytes.                        *
+ * ================================================================ */
+
+/* Called for every token buf[start .. start+len); `line` is the line
+ * count (see ScanText) at the token. */
+typedef void (*ScanTokenFn)(void *ctx, size_t start, size_t len, size_t line);
+
+/* Report the tokens of buf[0..len) in order and add the newlines of the
+ * buffer to *line. The buffer must end at a token boundary (the end of
+ * the input, or ScanSafeEnd). */
+void ScanText(const char *buf, size_t len, size_t *line, ScanTokenFn fn, void *ctx);
+
+/* Largest n <= len such that buf[n-1] is an ASCII non-letter: neither a
+ * token nor a UTF-8 sequence can straddle n. 0 if there is none. */
+size_t ScanSafeEnd(const char *buf, size_t len);
+
+/* An ASCII byte that can never be part of a token. */
+static inline int ScanIsSeparator(char c) {
+    unsigned char u = (unsigned char)c;
+    return u < 0x80 && (unsigned char)((u | 0x20) - 'a') >= 26u;
+}
+
+/* dst[0..n) = src[0..n) with a-z folded to A-Z (other bytes unchanged);
+ * dst may equal src. */
+void ScanUpperCopy(char *dst, const char *src, size_t n);
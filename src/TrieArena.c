@@ -0,0 +1,215 @@
+#include "TrieArena.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+/* ========================= *
+ * Slab chunks               *
+ * ========================= */
+
+#define ARENA_FIRST_CHUNK  (64u * 1024u)
+#define ARENA_MAX_CHUNK    (4u * 1024u * 1024u)
+#define ARENA_ALIGN        sizeof(void*)
+
+static void SlabInit(ArenaSlab *s) {
+    s->chunks = NULL;
+    s->cur = NULL;
+    s->left = 0;
+    s->nextChunk = ARENA_FIRST_CHUNK;
+}
+
+static void SlabFree(ArenaSlab *s) {
+    ArenaChunk *c = s->chunks;
+    while (c) {
+        ArenaChunk *next = c->next;
+        free(c);
+        c = next;
+    }
+    SlabInit(s);
+}
+
+/* Bump-allocate `n` bytes; `align` is 1 or ARENA_ALIGN. Chunks grow
+ * geometrically so a large dictionary needs only a few dozen of them. */
+static void *SlabAlloc(ArenaSlab *s, size_t n, size_t align) {
+    size_t pad = (align - ((size_t)s->cur & (align - 1))) & (align - 1);
+
+    if (!s->cur || pad + n > s->left) {
+        size_t size = s->nextChunk;
+        while (size < n) size *= 2;
+
+        ArenaChunk *c = (ArenaChunk*)malloc(sizeof(ArenaChunk) + size);
+        if (!c) Error("out of memory: arena chunk");
+        c->next = s->chunks;
+        c->size = size;
+        s->chunks = c;
+        s->cur  = (char*)(c + 1);     /* header size keeps pointer alignment */
+        s->left = size;
+        pad = 0;
+        if (s->nextChunk < ARENA_MAX_CHUNK) s->nextChunk *= 2;
+    }
+
+    void *mem = s->cur + pad;
+    s->cur  += pad + n;
+    s->left -= pad + n;
+    return mem;
+}
+
+/* Free lists thread through the first pointer-sized word of a record. */
+static void *PopFree(void **list) {
+    void *item = *list;
+    if (item) *list = *(void**)item;
+    return item;
+}
+
+static void PushFree(void **list, void *item) {
+    *(void**)item = *list;
+    *list = item;
+}
+
+/* ========================= *
+ * Arena lifetime            *
+ * ========================= */
+
+TrieArena *ArenaCreate(void) {
+    TrieArena *a = (TrieArena*)calloc(1, sizeof(*a));
+    if (!a) Error("out of memory: ArenaCreate");
+    SlabInit(&a->nodes);
+    SlabInit(&a->edges);
+    SlabInit(&a->suffixes);
+    a->root.kind = !leaf;
+    a->root.EndOfWord = !yes;
+    return a;
+}
+
+void ArenaDestroy(TrieArena *a) {
+    if (!a) return;
+    SlabFree(&a->nodes);
+    SlabFree(&a->edges);
+    SlabFree(&a->suffixes);
+    free(a);
+}
+
+/* Append src's chunks to dst's. Bumping continues in whichever current
+ * chunk has more room left; the other one's tail stays unused. */
+static void SlabAdopt(ArenaSlab *dst, ArenaSlab *src) {
+    if (!src->chunks) return;
+    if (src->left > dst->left) {
+        ArenaSlab t = *dst;
+        *dst = *src;
+        *src = t;
+    }
+    ArenaChunk **tail = &dst->chunks;
+    while (*tail) tail = &(*tail)->next;
+    *tail = src->chunks;
+    if (src->nextChunk > dst->nextChunk) dst->nextChunk = src->nextChunk;
+    SlabInit(src);
+}
+
+static void FreeListAdopt(void **dst, void *src) {
+    if (!src) return;
+    void *last = src;
+    while (*(void**)last) last = *(void**)last;
+    *(void**)last = *dst;
+    *dst = src;
+}
+
+void ArenaAdopt(TrieArena *a, TrieArena *from) {
+    SlabAdopt(&a->nodes, &from->nodes);
+    SlabAdopt(&a->edges, &from->edges);
+    SlabAdopt(&a->suffixes, &from->suffixes);
+    FreeListAdopt(&a->freeLeaves, from->freeLeaves);
+    FreeListAdopt(&a->freeNonLeaves, from->freeNonLeaves);
+    for (int cls = 0; cls < ARENA_EDGE_CLASSES; ++cls)
+        FreeListAdopt(&a->freeEdges[cls], from->freeEdges[cls]);
+    a->suffixBytes += from->suffixBytes;
+    a->suffixLive += from->suffixLive;
+    free(from);
+}
+
+/* ========================= *
+ * Records                   *
+ * ========================= */
+
+NonLeafPtr ArenaNewNonLeaf(TrieArena *a) {
+    NonLeafPtr p = (NonLeafPtr)PopFree(&a->freeNonLeaves);
+    if (!p) p = (NonLeafPtr)SlabAlloc(&a->nodes, sizeof(*p), ARENA_ALIGN);
+    memset(p, 0, sizeof(*p));
+    return p;
+}
+
+LeafPtr ArenaNewLeaf(TrieArena *a) {
+    LeafPtr lf = (LeafPtr)PopFree(&a->freeLeaves);
+    if (!lf) lf = (LeafPtr)SlabAlloc(&a->nodes, sizeof(*lf), ARENA_ALIGN);
+    memset(lf, 0, sizeof(*lf));
+    return lf;
+}
+
+void ArenaFreeNonLeaf(TrieArena *a, NonLeafPtr p) {
+    PushFree(&a->freeNonLeaves, p);
+}
+
+void ArenaFreeLeaf(TrieArena *a, LeafPtr lf) {
+    PushFree(&a->freeLeaves, lf);
+}
+
+char *ArenaSuffixAlloc(TrieArena *a, size_t n) {
+    char *mem = (char*)SlabAlloc(&a->suffixes, n + 1, 1);
+    mem[n] = '\0';
+    a->suffixBytes += n + 1;
+    return mem;
+}
+
+char *ArenaSuffix(TrieArena *a, const char *s, size_t n) {
+    char *copy = ArenaSuffixAlloc(a, n);
+    memcpy(copy, s, n);
+    return copy;
+}
+
+ArenaSlab ArenaSuffixesDetach(TrieArena *a) {
+    ArenaSlab old = a->suffixes;
+    SlabInit(&a->suffixes);
+    a->suffixBytes = 0;
+    return old;
+}
+
+void ArenaSlabRelease(ArenaSlab *s) {
+    SlabFree(s);
+}
+
+/* ========================= *
+ * Edge blocks               *
+ * ========================= */
+
+int EdgeClass(int n) {
+    int cls = 0;
+    while ((1 << cls) < n) ++cls;
+    return cls;
+}
+
+#define EDGE_BITMAP_BYTES (4 * sizeof(uint64_t))
+
+static size_t EdgeBitmapBytes(int cls) {
+    return cls >= TRIE_WIDE_CLASS ? EDGE_BITMAP_BYTES : 0;
+}
+
+static size_t EdgeBlockSize(int cls) {
+    size_t cap = (size_t)1 << cls;
+    size_t letters = (cap + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+    return EdgeBitmapBytes(cls) + cap * sizeof(NonLeafPtr) + letters;
+}
+
+NonLeafPtr *ArenaEdgeBlock(TrieArena *a, int cls, char **letters) {
+    if (cls < 0 || cls >= ARENA_EDGE_CLASSES) Error("ArenaEdgeBlock: too many edges");
+
+    char *block = (char*)PopFree(&a->freeEdges[cls]);
+    if (!block) block = (char*)SlabAlloc(&a->edges, EdgeBlockSize(cls), ARENA_ALIGN);
+    memset(block, 0, EdgeBlockSize(cls));
+
+    NonLeafPtr *ptrs = (NonLeafPtr*)(block + EdgeBitmapBytes(cls));
+    *letters = (char*)(ptrs + ((size_t)1 << cls));
+    return ptrs;
+}
+
+void ArenaFreeEdgeBlock(TrieArena *a, int cls, NonLeafPtr *ptrs) {
+    PushFree(&a->freeEdges[cls], (char*)ptrs - EdgeBitmapBytes(cls));
+}
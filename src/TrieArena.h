@@ -0,0 +1,85 @@
+#pragma once
+#include "SimpleTrieSpellChecker.h"
+
+/* ================================================================ *
+ * Arena / slab storage for one trie (library-private)              *
+ *                                                                  *
+ * Every trie owns a TrieArena. The arena carries three bump-       *
+ * allocated slabs, each a singly linked chain of large chunks:     *
+ *  - nodes:    NonLeafNode / LeafNode records,                     *
+ *  - edges:    letters+ptrs blocks in power-of-two size classes,   *
+ *  - suffixes: NUL-terminated leaf suffix bytes.                   *
+ *                                                                  *
+ * Records released during insert (split leaves, outgrown edge      *
+ * blocks) go to per-type / per-class free lists and are reused by  *
+ * the next allocation of the same shape. Nothing is returned to    *
+ * the C heap until ArenaDestroy, which drops whole chunks.         *
+ *                                                                  *
+ * The root non-leaf is embedded as the FIRST member of the arena,  *
+ * so the public API can keep passing `NonLeafPtr root` around and  *
+ * still reach the arena with ArenaOf(root).                        *
+ * ================================================================ */
+
+#define ARENA_EDGE_CLASSES 9      /* edge capacities 1, 2, 4, ..., 256 */
+#define TRIE_WIDE_CLASS    6      /* classes (cap >= 64) carrying a bitmap */
+
+typedef struct ArenaChunk {
+    struct ArenaChunk *next;
+    size_t size;                  /* usable bytes following the header */
+} ArenaChunk;
+
+typedef struct {
+    ArenaChunk *chunks;           /* newest first */
+    char  *cur;                   /* bump pointer inside chunks */
+    size_t left;                  /* bytes left in the current chunk */
+    size_t nextChunk;             /* size of the next chunk to reserve */
+} ArenaSlab;
+
+typedef struct TrieArena {
+    struct NonLeafNode root;      /* MUST stay first, see ArenaOf() */
+    ArenaSlab nodes;
+    ArenaSlab edges;
+    ArenaSlab suffixes;
+    void *freeLeaves;             /* recycled LeafNode records */
+    void *freeNonLeaves;          /* recycled NonLeafNode records */
+    void *freeEdges[ARENA_EDGE_CLASSES];
+    size_t suffixBytes;           /* handed out by ArenaSuffix* since the slab was (re)started */
+    size_t suffixLive;            /* live suffix bytes at the last check (TrieRemove) */
+} TrieArena;
+
+#define ArenaOf(root) ((TrieArena*)(root))
+
+TrieArena *ArenaCreate(void);
+void       ArenaDestroy(TrieArena *a);
+
+/* Move everything `from` owns (chunks, free lists) into `a` and release
+ * `from` itself: nodes built in `from` can then be linked into a's trie.
+ * from->root goes away with it, so nothing may point at it any more. */
+void       ArenaAdopt(TrieArena *a, TrieArena *from);
+
+NonLeafPtr ArenaNewNonLeaf(TrieArena *a);            /* zeroed record */
+LeafPtr    ArenaNewLeaf(TrieArena *a);               /* zeroed record */
+void       ArenaFreeNonLeaf(TrieArena *a, NonLeafPtr p);
+void       ArenaFreeLeaf(TrieArena *a, LeafPtr lf);
+
+/* Copy `n` bytes of `s` plus a terminating NUL into the suffix slab. */
+char *ArenaSuffix(TrieArena *a, const char *s, size_t n);
+
+/* Reserve `n` writable bytes plus a terminating NUL in the suffix slab. */
+char *ArenaSuffixAlloc(TrieArena *a, size_t n);
+
+/* Suffix bytes are never freed one by one (splits share them), so removals
+ * leave dead bytes behind. To compact: detach the current suffix slab (new
+ * suffixes start a fresh one), re-copy every live suffix, then release the
+ * detached chunks. */
+ArenaSlab ArenaSuffixesDetach(TrieArena *a);
+void      ArenaSlabRelease(ArenaSlab *s);
+
+/* Edge blocks: [256-bit bitmap, classes >= TRIE_WIDE_CLASS only]
+ * [(1 << cls) child pointers][(1 << cls) letter bytes, 8-aligned].
+ * EdgeClass(n) is the smallest class that holds n edges; a block is
+ * full when n is a power of two. Blocks are handed out and taken back
+ * by their `ptrs` address; the bitmap (if any) sits just below it. */
+int         EdgeClass(int n);
+NonLeafPtr *ArenaEdgeBlock(TrieArena *a, int cls, char **letters);
+void        ArenaFreeEdgeBlock(TrieArena *a, int cls, NonLeafPtr *ptrs);
@@ -0,0 +1,109 @@
+#include "TrieNode.h"
+#include <string.h>
+
+/* ================================================================ *
+ * Batched exact lookup (asynchronous memory access chaining)       *
+ *                                                                  *
+ * A lookup is a chain of dependent loads: node record -> its edge  *
+ * block -> the child's record -> ... -> leaf suffix. SearchTrie    *
+ * waits for each of them in turn. Here every in-flight lookup is a *
+ * small state machine that does one step per turn and prefetches  *
+ * the memory its NEXT step will touch; by the time the round-robin *
+ * comes back to it, the line is (ideally) in cache. A finished     *
+ * slot is refilled with the next word right away, so the pipeline  *
+ * stays full until the input runs out.                             *
+ *                                                                  *
+ *   stageNode:  read kind / count / EndOfWord of p; prefetch the   *
+ *               edge block (or the leaf suffix),                   *
+ *   stageEdges: Position() the next letter; prefetch the child,    *
+ *   stageTail:  compare the rest of the word with the leaf suffix. *
+ * ================================================================ */
+
+#define BATCH_INFLIGHT 16
+
+enum { stageNode, stageEdges, stageTail };
+
+typedef struct {
+    NonLeafPtr p;                 /* node (or leaf) this lookup is at */
+    const char *w;                /* unconsumed input */
+    size_t i;                     /* index into words / results */
+    int stage;
+} Lookup;
+
+static void Start(Lookup *l, NonLeafPtr root, const char *word, size_t i) {
+    TRIE_COUNT(searches, 1);
+    l->p = root;
+    l->w = word;
+    l->i = i;
+    l->stage = stageNode;
+}
+
+/* Advance one step; returns 1 once results[l->i] is written. */
+static int Step(Lookup *l, int *results) {
+    NonLeafPtr p = l->p;
+    int pos;
+
+    switch (l->stage) {
+    case stageNode:
+        TRIE_COUNT(searchNodes, 1);
+        if (p->kind == leaf) {
+            TriePrefetch(((LeafPtr)p)->word);
+            l->stage = stageTail;
+            return 0;
+        }
+        if (*l->w == '\0') {
+            results[l->i] = (p->EndOfWord == yes) ? success : !success;
+            return 1;
+        }
+        if (p->count == 0) {
+            results[l->i] = !success;
+            return 1;
+        }
+        TriePrefetch(p->count > TRIE_SIMD_MAX ? (const void*)EdgeBitmap(p) : (const void*)p->letters);
+        TriePrefetch(p->ptrs);
+        l->stage = stageEdges;
+        return 0;
+
+    case stageEdges:
+        if ((pos = Position(p, *l->w)) == notFound || !p->ptrs[pos]) {
+            results[l->i] = !success;
+            return 1;
+        }
+        l->p = p->ptrs[pos];
+        ++l->w;
+        TriePrefetch(l->p);
+        l->stage = stageNode;
+        return 0;
+
+    default:                      /* stageTail */
+        TRIE_COUNT(tailCompares, 1);
+        results[l->i] = strcmp(l->w, ((LeafPtr)p)->word) == 0 ? success : !success;
+        return 1;
+    }
+}
+
+void SearchTrieBatch(NonLeafPtr root, const char *const *words, size_t n, int *results) {
+    Lookup q[BATCH_INFLIGHT];
+    size_t next = 0;
+    int active = 0;
+
+    while (active < BATCH_INFLIGHT && next < n) {
+        Start(&q[active], root, words[next], next);
+        ++active;
+        ++next;
+    }
+
+    while (active > 0) {
+        for (int k = 0; k < active; ) {
+            if (!Step(&q[k], results)) {
+                ++k;
+            } else if (next < n) {
+                Start(&q[k], root, words[next], next);
+                ++next;
+                ++k;
+            } else {
+                q[k] = q[--active];   /* retire: the moved lookup runs now */
+            }
+        }
+    }
+}
@@ -0,0 +1,105 @@
+#include "TrieNode.h"
+#include <string.h>
+
+/* ================================================================ *
+ * Bulk build from a sorted word list                               *
+ *                                                                  *
+ * For sorted input every subtree is a contiguous range of words    *
+ * sharing the prefix consumed so far, so one recursive pass can    *
+ * create each node exactly once:                                   *
+ *  - a word ending at `depth` sets EndOfWord (it sorts first),     *
+ *  - the remaining words are grouped by their char at `depth`;     *
+ *    the group count sizes the edge block up front,                *
+ *  - a group of one word becomes a path-compressed leaf,           *
+ *    larger groups recurse one level down.                         *
+ * Total work is O(total characters); no leaf is ever split or      *
+ * freed and no edge block is ever regrown. The result is the same  *
+ * trie TrieInsert builds for the same words.                       *
+ * ================================================================ */
+
+/* Order of the trie's edge labels: `char` comparison, shorter first. */
+static int CompareTrieOrder(const char *a, const char *b) {
+    while (*a && *a == *b) { ++a; ++b; }
+    if (*a == *b) return 0;
+    if (!*a) return -1;
+    if (!*b) return 1;
+    return *a < *b ? -1 : 1;
+}
+
+int TrieCheckSorted(const char **words, size_t n, size_t *badIndex) {
+    if (n == 0) {
+        if (badIndex) *badIndex = 0;
+        return bulkEmptyInput;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        int rc = bulkOk;
+        if (!words[i] || !*words[i]) {
+            rc = bulkEmptyWord;
+        } else if (i > 0) {
+            int cmp = CompareTrieOrder(words[i - 1], words[i]);
+            if (cmp == 0) rc = bulkDuplicate;
+            else if (cmp > 0) rc = bulkUnsorted;
+        }
+        if (rc != bulkOk) {
+            if (badIndex) *badIndex = i;
+            return rc;
+        }
+    }
+    return bulkOk;
+}
+
+static NonLeafPtr NewLeaf(TrieArena *a, const char *suffix) {
+    LeafPtr lf = ArenaNewLeaf(a);
+    lf->kind = leaf;
+    lf->word = ArenaSuffix(a, suffix, strlen(suffix));
+    return (NonLeafPtr)lf;
+}
+
+/* Fill non-leaf `p` from words[lo..hi), which share their first `depth` chars. */
+static void FillNode(TrieArena *a, NonLeafPtr p, const char **words,
+                     size_t lo, size_t hi, size_t depth) {
+    if (words[lo][depth] == '\0') {
+        p->EndOfWord = yes;
+        ++lo;
+    }
+
+    int groups = 0;
+    for (size_t i = lo; i < hi; ++i)
+        if (i == lo || words[i][depth] != words[i - 1][depth]) ++groups;
+    if (groups == 0) return;
+
+    int cls = EdgeClass(groups);
+    char *letters;
+    p->ptrs = ArenaEdgeBlock(a, cls, &letters);
+    p->letters = letters;
+    p->count = (unsigned)groups;
+
+    int e = 0;
+    for (size_t i = lo; i < hi; ++e) {
+        char ch = words[i][depth];
+        size_t j = i + 1;
+        while (j < hi && words[j][depth] == ch) ++j;
+
+        p->letters[e] = ch;
+        if (cls >= TRIE_WIDE_CLASS) BitmapSet(EdgeBitmap(p), ch);
+
+        if (j - i == 1) {
+            p->ptrs[e] = NewLeaf(a, words[i] + depth + 1);
+        } else {
+            NonLeafPtr child = ArenaNewNonLeaf(a);
+            child->kind = !leaf;
+            child->EndOfWord = !yes;
+            FillNode(a, child, words, i, j, depth + 1);
+            p->ptrs[e] = child;
+        }
+        i = j;
+    }
+}
+
+NonLeafPtr TrieBuildFromSorted(const char **words, size_t n, size_t *badIndex) {
+    if (TrieCheckSorted(words, n, badIndex) != bulkOk) return NULL;
+
+    TrieArena *a = ArenaCreate();
+    FillNode(a, &a->root, words, 0, n, 0);
+    return &a->root;
+}
@@ -0,0 +1,233 @@
+#include "TrieNode.h"
+#include "TrieSuggest.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* ================================================================ *
+ * Prefix completion (best-first by cached maximum weight)          *
+ *                                                                  *
+ * After walking the prefix, the subtree below it is explored with  *
+ * a max-heap of candidates. A candidate is either a word (key: its *
+ * weight) or an unexpanded node (key: its maxWeight, an upper      *
+ * bound on every word below it). Popping a word emits it; popping  *
+ * a node pushes its own word and its children. Since no node can   *
+ * hide a word heavier than its key, the words come out heaviest    *
+ * first and the walk stops after k of them: the work grows with k  *
+ * times the depth and fan-out, not with the subtree size.          *
+ *                                                                  *
+ * Ties are broken by path, then words before nodes: every word     *
+ * below a node sorts at or after the node's path, so words of      *
+ * equal weight come out in alphabetical order (and a dictionary    *
+ * without weights completes alphabetically).                       *
+ *                                                                  *
+ * The k heaviest word keys pushed so far are tracked as well (a    *
+ * min-heap): a candidate lighter than the k-th of them can never   *
+ * be emitted and is not pushed, which keeps the frontier close to  *
+ * the few nodes on the paths to the answers.                       *
+ *                                                                  *
+ * Candidates, their paths and the key heap start in fixed buffers  *
+ * on the stack; only a frontier larger than those (very wide       *
+ * nodes, long words, large k) touches the heap.                    *
+ * ================================================================ */
+
+#define COMPLETE_LOCAL       256          /* candidates held on the stack */
+#define COMPLETE_LOCAL_BYTES 4096         /* path bytes held on the stack */
+
+typedef struct {
+    NonLeafPtr node;              /* NULL: a complete word */
+    unsigned int key;             /* word weight, or subtree maxWeight */
+    unsigned int len;             /* path length */
+    size_t path;                  /* offset of the NUL-terminated path */
+} Candidate;
+
+typedef struct {
+    Candidate *heap;
+    int n, cap;
+    char *bytes;
+    size_t used, bytesCap;
+    unsigned int *best;           /* min-heap of the heaviest word keys pushed */
+    int nBest, k;
+    Candidate heapLocal[COMPLETE_LOCAL];
+    char bytesLocal[COMPLETE_LOCAL_BYTES];
+    unsigned int bestLocal[COMPLETE_LOCAL];
+} Frontier;
+
+static const char *PathOf(const Frontier *f, const Candidate *c) {
+    return f->bytes + c->path;
+}
+
+/* Should a come out before b? */
+static int Before(const Frontier *f, const Candidate *a, const Candidate *b) {
+    if (a->key != b->key) return a->key > b->key;
+    unsigned int n = a->len < b->len ? a->len : b->len;
+    int cmp = memcmp(PathOf(f, a), PathOf(f, b), n);
+    if (cmp != 0) return cmp < 0;
+    if (a->len != b->len) return a->len < b->len;
+    return a->node == NULL && b->node != NULL;
+}
+
+static void SiftUp(Frontier *f, int i) {
+    Candidate *h = f->heap;
+    while (i > 0) {
+        int up = (i - 1) / 2;
+        if (!Before(f, &h[i], &h[up])) break;
+        Candidate t = h[i]; h[i] = h[up]; h[up] = t;
+        i = up;
+    }
+}
+
+static void SiftDown(Frontier *f, int i) {
+    Candidate *h = f->heap;
+    while (1) {
+        int l = 2 * i + 1, r = l + 1, m = i;
+        if (l < f->n && Before(f, &h[l], &h[m])) m = l;
+        if (r < f->n && Before(f, &h[r], &h[m])) m = r;
+        if (m == i) return;
+        Candidate t = h[i]; h[i] = h[m]; h[m] = t;
+        i = m;
+    }
+}
+
+/* Grow a buffer that may still be the stack one. */
+static void *Grow(void *buf, const void *local, size_t bytes, size_t newBytes) {
+    void *p;
+    if (buf == local) {
+        p = malloc(newBytes);
+        if (p) memcpy(p, buf, bytes);
+    } else {
+        p = realloc(buf, newBytes);
+    }
+    if (!p) Error("out of memory: TrieComplete");
+    return p;
+}
+
+/* Record the key of a pushed word among the k heaviest. */
+static void KeepBest(Frontier *f, unsigned int key) {
+    unsigned int *h = f->best;
+    int i;
+    if (f->nBest < f->k) {
+        for (i = f->nBest++; i > 0 && h[(i - 1) / 2] > key; i = (i - 1) / 2) h[i] = h[(i - 1) / 2];
+        h[i] = key;
+        return;
+    }
+    if (key <= h[0]) return;
+    for (i = 0; ; ) {                             /* replace the lightest, sift down */
+        int l = 2 * i + 1, r = l + 1, m = l;
+        if (l >= f->nBest) break;
+        if (r < f->nBest && h[r] < h[l]) m = r;
+        if (h[m] >= key) break;
+        h[i] = h[m];
+        i = m;
+    }
+    h[i] = key;
+}
+
+/* Push a candidate whose path is base[0..baseLen) + `letter` (if not
+ * '\0') + tail. `base` may point into the path bytes. */
+static void Push(Frontier *f, NonLeafPtr node, unsigned int key, size_t baseOff, unsigned int baseLen,
+                 const char *base, char letter, const char *tail) {
+    if (f->nBest == f->k && key < f->best[0]) return;   /* k heavier words are queued */
+
+    size_t lt = strlen(tail);
+    size_t len = (size_t)baseLen + (letter != '\0') + lt;
+
+    if (f->n == f->cap) {
+        f->heap = (Candidate*)Grow(f->heap, f->heapLocal, (size_t)f->cap * sizeof(Candidate),
+                                   (size_t)f->cap * 2 * sizeof(Candidate));
+        f->cap *= 2;
+    }
+    if (f->used + len + 1 > f->bytesCap) {
+        size_t cap = f->bytesCap * 2;
+        while (cap < f->used + len + 1) cap *= 2;
+        f->bytes = (char*)Grow(f->bytes, f->bytesLocal, f->used, cap);
+        f->bytesCap = cap;
+    }
+    if (!base) base = f->bytes + baseOff;         /* after a possible move */
+
+    char *dst = f->bytes + f->used;
+    memcpy(dst, base, baseLen);
+    if (letter != '\0') dst[baseLen] = letter;
+    memcpy(dst + len - lt, tail, lt);
+    dst[len] = '\0';
+
+    Candidate *c = &f->heap[f->n];
+    c->node = node;
+    c->key = key;
+    c->len = (unsigned int)len;
+    c->path = f->used;
+    f->used += len + 1;
+    SiftUp(f, f->n++);
+    if (!node) KeepBest(f, key);
+}
+
+/* Push the word of p (if any) and its children, below path `at`. */
+static void Expand(Frontier *f, NonLeafPtr p, const Candidate *at) {
+    size_t off = at->path;
+    unsigned int len = at->len;
+
+    /* every child's key is read below: start all the misses at once */
+    for (int i = 0; i < (int)p->count; ++i)
+        if (p->ptrs[i]) TriePrefetch(p->ptrs[i]);
+
+    if (p->EndOfWord == yes) Push(f, NULL, p->weight, off, len, NULL, '\0', "");
+    for (int i = 0; i < (int)p->count; ++i) {
+        NonLeafPtr child = p->ptrs[i];
+        if (!child) continue;
+        if (child->kind == leaf) {
+            LeafPtr lf = (LeafPtr)child;
+            Push(f, NULL, lf->weight, off, len, NULL, p->letters[i], lf->word);
+        } else {
+            Push(f, child, child->maxWeight, off, len, NULL, p->letters[i], "");
+        }
+    }
+}
+
+void TrieComplete(NonLeafPtr root, const char *prefix, int k, SuggestResult *out) {
+    ResultReset(out, k);
+    if (k <= 0) return;
+
+    Frontier frontier, *f = &frontier;
+    f->heap = f->heapLocal;
+    f->n = 0;
+    f->cap = COMPLETE_LOCAL;
+    f->bytes = f->bytesLocal;
+    f->used = 0;
+    f->bytesCap = COMPLETE_LOCAL_BYTES;
+    f->best = k <= COMPLETE_LOCAL ? f->bestLocal : (unsigned int*)malloc((size_t)k * sizeof(unsigned int));
+    f->nBest = 0;
+    f->k = k;
+    if (!f->best) Error("out of memory: TrieComplete");
+
+    /* walk the prefix; it may end inside a leaf's suffix */
+    NonLeafPtr p = root;
+    size_t i = 0, plen = strlen(prefix);
+    while (1) {
+        if (p->kind == leaf) {
+            LeafPtr lf = (LeafPtr)p;
+            if (strncmp(lf->word, prefix + i, plen - i) == 0)
+                Push(f, NULL, lf->weight, 0, (unsigned int)i, prefix, '\0', lf->word);
+            break;
+        }
+        if (i == plen) {
+            Push(f, p, p->maxWeight, 0, (unsigned int)plen, prefix, '\0', "");
+            break;
+        }
+        int pos = Position(p, prefix[i]);
+        if (pos == notFound || !p->ptrs[pos]) break;
+        p = p->ptrs[pos];
+        ++i;
+    }
+
+    while (f->n > 0 && out->count < k) {
+        Candidate top = f->heap[0];
+        f->heap[0] = f->heap[--f->n];
+        SiftDown(f, 0);
+
+        if (top.node) Expand(f, top.node, &top);
+        else          ResultAddWord(out, PathOf(f, &top), "");
+    }
+
+    if (f->heap != f->heapLocal) free(f->heap);
+    if (f->bytes != f->bytesLocal) free(f->bytes);
+    if (f->best != f->bestLocal) free(f->best);
+}
@@ -0,0 +1,128 @@
+#include "TrieFrozen.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/* ================================================================ *
+ * Binary dictionary files                                          *
+ *                                                                  *
+ * A dictionary file is the frozen blob written verbatim (see       *
+ * TrieFrozen.h). Loading maps the file read-only and points a      *
+ * FrozenTrie at the mapping: no parsing, no per-node work, and the *
+ * page-cache pages are shared by every process mapping the file.   *
+ *                                                                  *
+ * Saving writes `<path>.tmp` and renames it over `<path>`, so a    *
+ * worker that still maps the previous file keeps reading the old   *
+ * (unlinked) pages instead of a half-written new one.              *
+ * ================================================================ */
+
+static int ReplaceFile(const char *tmp, const char *path) {
+#if defined(_WIN32)
+    return MoveFileExA(tmp, path, MOVEFILE_REPLACE_EXISTING) ? success : !success;
+#else
+    return rename(tmp, path) == 0 ? success : !success;
+#endif
+}
+
+int FrozenTrieSave(const FrozenTrie *ft, const char *path) {
+    size_t n = strlen(path);
+    char *tmp = (char*)malloc(n + 5);
+    if (!tmp) return !success;
+    memcpy(tmp, path, n);
+    memcpy(tmp + n, ".tmp", 5);
+
+    FILE *f = fopen(tmp, "wb");
+    int ok = f != NULL;
+    if (ok) ok = fwrite(ft->hdr, 1, ft->bytes, f) == ft->bytes;
+    if (f && fclose(f) != 0) ok = 0;
+    if (ok) ok = ReplaceFile(tmp, path) == success;
+    if (!ok) remove(tmp);
+
+    free(tmp);
+    return ok ? success : !success;
+}
+
+int TrieSave(NonLeafPtr root, const char *path) {
+    FrozenTrie *ft = TrieFreeze(root);
+    int rc = FrozenTrieSave(ft, path);
+    FrozenTrieDestroy(ft);
+    return rc;
+}
+
+#if defined(_WIN32)
+
+FrozenTrie *TrieOpenMapped(const char *path) {
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE,
+                              NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return NULL;
+
+    LARGE_INTEGER size;
+    HANDLE map = NULL;
+    void *base = NULL;
+    FrozenTrie *ft = NULL;
+
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+        map = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (map) base = MapViewOfFile(map, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(file);
+
+    if (base) ft = (FrozenTrie*)calloc(1, sizeof(*ft));
+    if (ft && FrozenAttach(ft, base, (size_t)size.QuadPart)) {
+        ft->mapBase = base;
+        ft->mapHandle = map;
+        return ft;
+    }
+
+    free(ft);
+    if (base) UnmapViewOfFile(base);
+    if (map) CloseHandle(map);
+    return NULL;
+}
+
+void FrozenUnmap(FrozenTrie *ft) {
+    UnmapViewOfFile(ft->mapBase);
+    CloseHandle((HANDLE)ft->mapHandle);
+    ft->mapBase = ft->mapHandle = NULL;
+}
+
+#else
+
+FrozenTrie *TrieOpenMapped(const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return NULL;
+
+    struct stat st;
+    void *base = MAP_FAILED;
+    FrozenTrie *ft = NULL;
+
+    if (fstat(fd, &st) == 0 && st.st_size > 0)
+        base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);                                  /* the mapping keeps the file alive */
+
+    if (base != MAP_FAILED) ft = (FrozenTrie*)calloc(1, sizeof(*ft));
+    if (ft && FrozenAttach(ft, base, (size_t)st.st_size)) {
+        ft->mapBase = base;
+        return ft;
+    }
+
+    free(ft);
+    if (base != MAP_FAILED) munmap(base, (size_t)st.st_size);
+    return NULL;
+}
+
+void FrozenUnmap(FrozenTrie *ft) {
+    munmap(ft->mapBase, ft->bytes);
+    ft->mapBase = NULL;
+}
+
+#endif
@@ -0,0 +1,447 @@
+#include "TrieFrozen.h"
+#include "TrieSuggest.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+
+/* ================================================================ *
+ * Freeze = minimize + lay out                                      *
+ *                                                                  *
+ * 1) Canon(): post-order hash-consing. Two non-leaves with the same *
+ *    EndOfWord flag, labels and (canonical) children accept the    *
+ *    same set of tails, so they become ONE record: the frozen form *
+ *    is a minimal acyclic automaton (DAWG) rather than a tree.     *
+ *    Leaf suffixes are interned the same way.                      *
+ * 2) Tail merging: a suffix that ends another suffix ("ING" in     *
+ *    "TING") points into that string instead of being stored.     *
+ * 3) Breadth-first layout of the unique records from the root.     *
+ *                                                                  *
+ * Traversals only ever walk downwards and rebuild the word in a    *
+ * prefix buffer, so sharing is invisible to search and suggest.    *
+ * ================================================================ */
+
+#define FREEZE_UNPLACED 0xffffffffu
+
+typedef struct {
+    NonLeafPtr rep;               /* first node seen with this shape */
+    size_t   codes;               /* its child codes start at b->codes[codes] */
+    uint32_t hash;
+    uint32_t offset;              /* word offset once laid out */
+} FreezeNode;
+
+typedef struct {
+    const char *s;
+    size_t   len;
+    uint32_t hash;
+    uint32_t offset;              /* byte offset in the suffix pool */
+} FreezeSuffix;
+
+typedef struct {
+    FreezeNode   *nodes;    size_t nNodes,    capNodes;
+    FreezeSuffix *sufs;     size_t nSufs,     capSufs;
+    uint32_t     *codes;    size_t nCodes,    capCodes;    /* per unique node */
+    uint32_t     *scratch;  size_t nScratch,  capScratch;  /* per DFS frame */
+    uint32_t     *nodeTable;  size_t nodeTableCap;         /* id + 1, 0 = empty */
+    uint32_t     *sufTable;   size_t sufTableCap;
+} FreezeBuilder;
+
+static void *GrowArray(void *arr, size_t *cap, size_t need, size_t elem) {
+    if (need <= *cap) return arr;
+    size_t n = *cap ? *cap : 64;
+    while (n < need) n *= 2;
+    arr = realloc(arr, n * elem);
+    if (!arr) Error("out of memory: TrieFreeze");
+    *cap = n;
+    return arr;
+}
+
+static uint32_t HashBytes(uint32_t h, const void *data, size_t n) {
+    const unsigned char *p = (const unsigned char*)data;
+    for (size_t i = 0; i < n; ++i) { h ^= p[i]; h *= 16777619u; }   /* FNV-1a */
+    return h;
+}
+
+/* Open-addressing table of ids; rebuilt at 50% load from the stored hashes. */
+static void TableGrow(uint32_t **table, size_t *cap, size_t used,
+                      const void *items, size_t itemSize, size_t hashOffset) {
+    if ((used + 1) * 2 <= *cap) return;
+    size_t n = *cap ? *cap * 2 : 1024;
+    uint32_t *t = (uint32_t*)calloc(n, sizeof(uint32_t));
+    if (!t) Error("out of memory: TrieFreeze");
+    for (size_t id = 0; id < used; ++id) {
+        uint32_t h;
+        memcpy(&h, (const char*)items + id * itemSize + hashOffset, sizeof(h));
+        size_t i = h & (n - 1);
+        while (t[i]) i = (i + 1) & (n - 1);
+        t[i] = (uint32_t)id + 1;
+    }
+    free(*table);
+    *table = t;
+    *cap = n;
+}
+
+static uint32_t InternSuffix(FreezeBuilder *b, const char *s) {
+    size_t len = strlen(s);
+    uint32_t h = HashBytes(2166136261u, s, len);
+
+    TableGrow(&b->sufTable, &b->sufTableCap, b->nSufs, b->sufs,
+              sizeof(FreezeSuffix), offsetof(FreezeSuffix, hash));
+    size_t i = h & (b->sufTableCap - 1);
+    for (; b->sufTable[i]; i = (i + 1) & (b->sufTableCap - 1)) {
+        const FreezeSuffix *f = &b->sufs[b->sufTable[i] - 1];
+        if (f->hash == h && f->len == len && memcmp(f->s, s, len) == 0)
+            return b->sufTable[i] - 1;
+    }
+
+    b->sufs = (FreezeSuffix*)GrowArray(b->sufs, &b->capSufs, b->nSufs + 1, sizeof(FreezeSuffix));
+    b->sufs[b->nSufs].s = s;
+    b->sufs[b->nSufs].len = len;
+    b->sufs[b->nSufs].hash = h;
+    b->sufTable[i] = (uint32_t)b->nSufs + 1;
+    return (uint32_t)b->nSufs++;
+}
+
+/* Canonical id of the subtree at `p`. Child codes are FROZEN_LEAF|suffix id
+ * or a node id; they are collected on the scratch stack (indexed, since the
+ * recursion may reallocate it). */
+static uint32_t Canon(FreezeBuilder *b, NonLeafPtr p) {
+    int n = (int)p->count;
+    size_t base = b->nScratch;
+    b->scratch = (uint32_t*)GrowArray(b->scratch, &b->capScratch, base + (size_t)n, sizeof(uint32_t));
+    b->nScratch += (size_t)n;
+
+    for (int i = 0; i < n; ++i) {
+        NonLeafPtr child = p->ptrs[i];
+        uint32_t code = child->kind == leaf
+            ? FROZEN_LEAF | InternSuffix(b, ((LeafPtr)child)->word)
+            : Canon(b, child);
+        b->scratch[base + (size_t)i] = code;
+    }
+
+    const uint32_t *codes = b->scratch + base;
+    uint32_t h = 2166136261u ^ (uint32_t)n ^ (p->EndOfWord == yes ? 0x400u : 0u);
+    h = HashBytes(h, p->letters, (size_t)n);
+    h = HashBytes(h, codes, (size_t)n * sizeof(uint32_t));
+
+    TableGrow(&b->nodeTable, &b->nodeTableCap, b->nNodes, b->nodes,
+              sizeof(FreezeNode), offsetof(FreezeNode, hash));
+    size_t i = h & (b->nodeTableCap - 1);
+    for (; b->nodeTable[i]; i = (i + 1) & (b->nodeTableCap - 1)) {
+        uint32_t id = b->nodeTable[i] - 1;
+        const FreezeNode *f = &b->nodes[id];
+        if (f->hash == h && f->rep->count == p->count && f->rep->EndOfWord == p->EndOfWord
+            && memcmp(f->rep->letters, p->letters, (size_t)n) == 0
+            && memcmp(b->codes + f->codes, codes, (size_t)n * sizeof(uint32_t)) == 0) {
+            b->nScratch = base;
+            return id;
+        }
+    }
+
+    b->codes = (uint32_t*)GrowArray(b->codes, &b->capCodes, b->nCodes + (size_t)n, sizeof(uint32_t));
+    memcpy(b->codes + b->nCodes, b->scratch + base, (size_t)n * sizeof(uint32_t));
+    b->nodes = (FreezeNode*)GrowArray(b->nodes, &b->capNodes, b->nNodes + 1, sizeof(FreezeNode));
+    b->nodes[b->nNodes].rep = p;
+    b->nodes[b->nNodes].codes = b->nCodes;
+    b->nodes[b->nNodes].hash = h;
+    b->nodes[b->nNodes].offset = FREEZE_UNPLACED;
+    b->nCodes += (size_t)n;
+    b->nodeTable[i] = (uint32_t)b->nNodes + 1;
+    b->nScratch = base;
+    return (uint32_t)b->nNodes++;
+}
+
+/* Order suffixes by their REVERSED text: a suffix of another string then
+ * sorts directly in front of the strings it ends. */
+static int CompareReversed(const void *x, const void *y) {
+    const FreezeSuffix *a = *(const FreezeSuffix* const*)x;
+    const FreezeSuffix *b = *(const FreezeSuffix* const*)y;
+    size_t i = a->len, j = b->len;
+    while (i > 0 && j > 0) {
+        unsigned char ca = (unsigned char)a->s[--i], cb = (unsigned char)b->s[--j];
+        if (ca != cb) return ca < cb ? -1 : 1;
+    }
+    return (i > 0) - (j > 0);
+}
+
+/* Assign pool offsets with tail merging; returns the pool size. */
+static size_t PlaceSuffixes(FreezeBuilder *b) {
+    size_t top = 0;
+    FreezeSuffix **order = (FreezeSuffix**)malloc((b->nSufs ? b->nSufs : 1) * sizeof(*order));
+    if (!order) Error("out of memory: TrieFreeze");
+    for (size_t i = 0; i < b->nSufs; ++i) order[i] = &b->sufs[i];
+    qsort(order, b->nSufs, sizeof(*order), CompareReversed);
+
+    for (size_t k = b->nSufs; k-- > 0; ) {
+        FreezeSuffix *f = order[k], *next = k + 1 < b->nSufs ? order[k + 1] : NULL;
+        if (next && f->len <= next->len
+            && memcmp(next->s + next->len - f->len, f->s, f->len) == 0) {
+            f->offset = next->offset + (uint32_t)(next->len - f->len);
+        } else {
+            f->offset = (uint32_t)top;
+            top += f->len + 1;
+            if (top > FROZEN_REF_MASK) Error("TrieFreeze: trie too large for 32-bit offsets");
+        }
+    }
+    free(order);
+    return top ? top : 1;
+}
+
+static void FreeBuilder(FreezeBuilder *b) {
+    free(b->nodes);
+    free(b->sufs);
+    free(b->codes);
+    free(b->scratch);
+    free(b->nodeTable);
+    free(b->sufTable);
+}
+
+FrozenTrie *TrieFreeze(NonLeafPtr root) {
+    FreezeBuilder b;
+    memset(&b, 0, sizeof(b));
+
+    uint32_t rootId = Canon(&b, root);
+    size_t suffixBytes = PlaceSuffixes(&b);
+
+    /* Breadth-first over the unique records: a record's offset is fixed
+     * the first time it is reached, so shared children are placed once. */
+    uint32_t *queue = (uint32_t*)malloc(b.nNodes * sizeof(uint32_t));
+    if (!queue) Error("out of memory: TrieFreeze");
+    size_t head = 0, tail = 0, words = 0;
+    queue[tail++] = rootId;
+    b.nodes[rootId].offset = 0;
+    words = FrozenNodeWords((int)root->count);
+
+    while (head < tail) {
+        const FreezeNode *f = &b.nodes[queue[head++]];
+        for (int i = 0; i < (int)f->rep->count; ++i) {
+            uint32_t code = b.codes[f->codes + (size_t)i];
+            if (code & FROZEN_LEAF) continue;
+            FreezeNode *c = &b.nodes[code];
+            if (c->offset != FREEZE_UNPLACED) continue;
+            if (words > FROZEN_REF_MASK) Error("TrieFreeze: trie too large for 32-bit offsets");
+            c->offset = (uint32_t)words;
+            words += FrozenNodeWords((int)c->rep->count);
+            queue[tail++] = code;
+        }
+    }
+
+    size_t bytes = sizeof(FrozenHeader) + words * sizeof(uint32_t) + suffixBytes;
+    FrozenTrie *ft = (FrozenTrie*)calloc(1, sizeof(*ft));
+    char *blob = (char*)calloc(1, bytes);
+    if (!ft || !blob) Error("out of memory: TrieFreeze");
+
+    FrozenHeader *hdr = (FrozenHeader*)blob;
+    memcpy(hdr->magic, FROZEN_MAGIC, sizeof(hdr->magic));
+    hdr->version     = FROZEN_VERSION;
+    hdr->headerBytes = (uint32_t)sizeof(FrozenHeader);
+    hdr->nodeWords   = (uint32_t)words;
+    hdr->suffixBytes = (uint32_t)suffixBytes;
+    hdr->nodeCount   = (uint32_t)b.nNodes;
+    hdr->byteOrder   = FROZEN_BYTE_ORDER;
+
+    uint32_t *nodes = (uint32_t*)(blob + sizeof(FrozenHeader));
+    char *suffixes = (char*)(nodes + words);
+
+    for (size_t i = 0; i < b.nSufs; ++i)
+        memcpy(suffixes + b.sufs[i].offset, b.sufs[i].s, b.sufs[i].len);
+
+    /* the queue holds every unique record in layout order */
+    for (size_t q = 0; q < tail; ++q) {
+        const FreezeNode *f = &b.nodes[queue[q]];
+        uint32_t *rec = nodes + f->offset;
+        int n = (int)f->rep->count;
+
+        rec[0] = (uint32_t)n | (f->rep->EndOfWord == yes ? FROZEN_EOW : 0u);
+        memcpy((char*)(rec + 1), f->rep->letters, (size_t)n);
+
+        uint32_t *refs = (uint32_t*)FrozenChildren(rec);
+        for (int i = 0; i < n; ++i) {
+            uint32_t code = b.codes[f->codes + (size_t)i];
+            refs[i] = (code & FROZEN_LEAF)
+                ? FROZEN_LEAF | b.sufs[code & FROZEN_REF_MASK].offset
+                : b.nodes[code].offset;
+        }
+    }
+    free(queue);
+    FreeBuilder(&b);
+
+    FrozenAttach(ft, blob, bytes);
+    ft->blob = blob;
+    return ft;
+}
+
+int FrozenAttach(FrozenTrie *ft, const void *blob, size_t bytes) {
+    const FrozenHeader *hdr = (const FrozenHeader*)blob;
+
+    if (bytes < sizeof(FrozenHeader)) return 0;
+    if (memcmp(hdr->magic, FROZEN_MAGIC, sizeof(hdr->magic)) != 0) return 0;
+    if (hdr->version != FROZEN_VERSION || hdr->byteOrder != FROZEN_BYTE_ORDER) return 0;
+    if (hdr->headerBytes != sizeof(FrozenHeader) || hdr->nodeWords == 0) return 0;
+    if ((size_t)hdr->headerBytes + (size_t)hdr->nodeWords * sizeof(uint32_t)
+        + (size_t)hdr->suffixBytes != bytes) return 0;
+
+    ft->hdr      = hdr;
+    ft->nodes    = (const uint32_t*)((const char*)blob + hdr->headerBytes);
+    ft->suffixes = (const char*)(ft->nodes + hdr->nodeWords);
+    ft->bytes    = bytes;
+    return 1;
+}
+
+void FrozenTrieDestroy(FrozenTrie *ft) {
+    if (!ft) return;
+    if (ft->mapBase) FrozenUnmap(ft);
+    free(ft->blob);
+    free(ft);
+}
+
+size_t FrozenTrieBytes(const FrozenTrie *ft) {
+    return ft ? ft->bytes : 0;
+}
+
+/* ========================= *
+ * Search                    *
+ * ========================= */
+
+int SearchFrozen(const FrozenTrie *ft, const char *word) {
+    const uint32_t *node = ft->nodes;
+
+    while (1) {
+        if (*word == '\0')
+            return (node[0] & FROZEN_EOW) ? success : !success;
+
+        int pos = FrozenPosition(node, *word);
+        if (pos == notFound) return !success;
+
+        uint32_t ref = FrozenChildren(node)[pos];
+        ++word;
+        if (ref & FROZEN_LEAF)
+            return strcmp(word, ft->suffixes + (ref & FROZEN_REF_MASK)) == 0 ? success : !success;
+        node = ft->nodes + ref;
+    }
+}
+
+/* ========================= *
+ * Suggestions (Damerau-1)   *
+ * ========================= *
+ * Same traversal and emission order as dfsSuggest on the pointer    *
+ * trie, so both forms return identical suggestion lists.           */
+
+static void dfsFrozen(const FrozenTrie *ft, const uint32_t *node, const char *in, int idx,
+                      char *prefix, int plen, int edits_used,
+                      SuggestResult *out, int MAX_SUGG) {
+    if (out->count >= MAX_SUGG) return;
+
+    if (in[idx] == '\0' && (node[0] & FROZEN_EOW)) {
+        prefix[plen] = '\0';
+        ResultAddWord(out, prefix, "");
+        if (out->count >= MAX_SUGG) return;
+    }
+
+    int n = (int)(node[0] & FROZEN_COUNT_MASK);
+    const char *labels = FrozenLabels(node);
+    const uint32_t *refs = FrozenChildren(node);
+
+    /* Insertion (extra input char): consume in[idx] and stay on this node. */
+    if (edits_used == 0 && in[idx] != '\0') {
+        dfsFrozen(ft, node, in, idx + 1, prefix, plen, 1, out, MAX_SUGG);
+        if (out->count >= MAX_SUGG) return;
+    }
+
+    for (int i = 0; i < n && out->count < MAX_SUGG; ++i) {
+        char edge = labels[i];
+        uint32_t ref = refs[i];
+        const char *suffix = ft->suffixes + (ref & FROZEN_REF_MASK);
+
+        /* exact match */
+        if (in[idx] != '\0' && in[idx] == edge) {
+            prefix[plen] = edge; prefix[plen + 1] = '\0';
+            if (ref & FROZEN_LEAF) {
+                if (TailWithinOneEdit(suffix, in + idx + 1, edits_used))
+                    ResultAddWord(out, prefix, suffix);
+            } else {
+                dfsFrozen(ft, ft->nodes + ref, in, idx + 1, prefix, plen + 1, edits_used, out, MAX_SUGG);
+            }
+            if (out->count >= MAX_SUGG) return;
+        }
+
+        /* substitution */
+        if (edits_used == 0 && in[idx] != '\0' && in[idx] != edge) {
+            prefix[plen] = edge; prefix[plen + 1] = '\0';
+            if (ref & FROZEN_LEAF) {
+                if (TailWithinOneEdit(suffix, in + idx + 1, 1))
+                    ResultAddWord(out, prefix, suffix);
+            } else {
+                dfsFrozen(ft, ft->nodes + ref, in, idx + 1, prefix, plen + 1, 1, out, MAX_SUGG);
+            }
+            if (out->count >= MAX_SUGG) return;
+        }
+
+        /* deletion: go down without consuming input */
+        if (edits_used == 0) {
+            prefix[plen] = edge; prefix[plen + 1] = '\0';
+            if (ref & FROZEN_LEAF) {
+                if (TailWithinOneEdit(suffix, in + idx, 1))
+                    ResultAddWord(out, prefix, suffix);
+            } else {
+                dfsFrozen(ft, ft->nodes + ref, in, idx, prefix, plen + 1, 1, out, MAX_SUGG);
+            }
+            if (out->count >= MAX_SUGG) return;
+        }
+    }
+
+    /* adjacent transposition: consume in[idx+1] first, then in[idx] */
+    if (edits_used == 0 && in[idx] != '\0' && in[idx + 1] != '\0') {
+        int pos1 = FrozenPosition(node, in[idx + 1]);
+        if (pos1 != notFound) {
+            uint32_t r1 = refs[pos1];
+
+            prefix[plen] = in[idx + 1]; prefix[plen + 1] = '\0';
+
+            if (r1 & FROZEN_LEAF) {
+                const char *s1 = ft->suffixes + (r1 & FROZEN_REF_MASK);
+                if (s1[0] == in[idx]) {
+                    if (TailWithinOneEdit(s1 + 1, in + idx + 2, 1))
+                        ResultAddWord(out, prefix, s1);
+                }
+            } else {
+                const uint32_t *c1 = ft->nodes + r1;
+                int pos2 = FrozenPosition(c1, in[idx]);
+                if (pos2 != notFound) {
+                    uint32_t r2 = FrozenChildren(c1)[pos2];
+
+                    prefix[plen + 1] = in[idx]; prefix[plen + 2] = '\0';
+
+                    if (r2 & FROZEN_LEAF) {
+                        const char *s2 = ft->suffixes + (r2 & FROZEN_REF_MASK);
+                        if (TailWithinOneEdit(s2, in + idx + 2, 1))
+                            ResultAddWord(out, prefix, s2);
+                    } else {
+                        dfsFrozen(ft, ft->nodes + r2, in, idx + 2, prefix, plen + 2, 1, out, MAX_SUGG);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void SuggestCorrectionsFrozenInto(const FrozenTrie *ft, const char *upper_word,
+                                  int maxSuggestions, SuggestResult *out) {
+    ResultReset(out, maxSuggestions);
+
+    char small[256];
+    char *prefix = SuggestPrefixBuffer(small, sizeof(small), upper_word);
+
+    dfsFrozen(ft, ft->nodes, upper_word, 0, prefix, 0, 0, out, out->cap);
+    SuggestPrefixFree(prefix, small);
+}
+
+void SuggestCorrectionsFrozen(const FrozenTrie *ft, const char *upper_word,
+                              int maxSuggestions, SuggestBox *outBox) {
+    if (!SuggestBoxInit(outBox, maxSuggestions)) return;
+
+    SuggestResult r;
+    SuggestResultInit(&r);
+    SuggestCorrectionsFrozenInto(ft, upper_word, maxSuggestions, &r);
+    ResultToBox(&r, outBox);
+    SuggestResultFree(&r);
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include "TrieNode.h"
+#include <stdint.h>
+
+/* ================================================================ *
+ * Frozen trie layout (library-private)                             *
+ *                                                                  *
+ * One contiguous blob:                                             *
+ *   [FrozenHeader][node records, uint32 words][suffix bytes]       *
+ *                                                                  *
+ * Node record (breadth-first order, root at word offset 0):        *
+ *   word 0:   count (bits 0..8) | FROZEN_EOW                       *
+ *   labels:   `count` sorted edge labels, zero-padded to 4 bytes   *
+ *   children: `count` uint32 refs                                  *
+ * A child ref with FROZEN_LEAF set is a byte offset of the leaf's  *
+ * NUL-terminated suffix in the suffix pool (leaves have no record);*
+ * otherwise it is the word offset of the child's record.           *
+ * Records and suffixes are shared wherever the tails they accept   *
+ * coincide (DAWG), so several refs may point at the same offset.   *
+ *                                                                  *
+ * Every offset is relative, so the blob is position independent    *
+ * and is written to disk verbatim (TrieSave / TrieOpenMapped).     *
+ * ================================================================ */
+
+#define FROZEN_MAGIC      "STSCTRIE"
+#define FROZEN_VERSION    1u
+#define FROZEN_BYTE_ORDER 0x01020304u  /* reads back swapped on foreign endianness */
+
+#define FROZEN_COUNT_MASK 0x1ffu
+#define FROZEN_EOW        0x200u
+#define FROZEN_LEAF       0x80000000u
+#define FROZEN_REF_MASK   0x7fffffffu
+
+typedef struct {
+    char     magic[8];            /* FROZEN_MAGIC, not NUL-terminated */
+    uint32_t version;             /* FROZEN_VERSION */
+    uint32_t headerBytes;         /* sizeof(FrozenHeader) */
+    uint32_t nodeWords;           /* size of the node area in uint32 words */
+    uint32_t suffixBytes;         /* size of the suffix pool */
+    uint32_t nodeCount;           /* number of node records */
+    uint32_t byteOrder;           /* FROZEN_BYTE_ORDER as written */
+} FrozenHeader;
+
+struct FrozenTrie {
+    const FrozenHeader *hdr;
+    const uint32_t *nodes;        /* node area; root at offset 0 */
+    const char *suffixes;         /* suffix pool */
+    size_t bytes;                 /* total blob size */
+    void *blob;                   /* owned heap copy (NULL when mapped) */
+    void *mapBase;                /* file mapping (TrieOpenMapped) */
+    void *mapHandle;              /* platform mapping handle, if any */
+};
+
+/* Point `ft` at a blob after checking its header; 0 if it is not a
+ * well-formed frozen trie of this version/byte order/size. */
+int  FrozenAttach(FrozenTrie *ft, const void *blob, size_t bytes);
+
+/* Platform side of TrieOpenMapped / FrozenTrieDestroy (TrieFile.c). */
+void FrozenUnmap(FrozenTrie *ft);
+
+static inline size_t FrozenNodeWords(int count) {
+    return 1u + (((size_t)count + 3u) >> 2) + (size_t)count;
+}
+
+static inline const char *FrozenLabels(const uint32_t *node) {
+    return (const char*)(node + 1);
+}
+
+static inline const uint32_t *FrozenChildren(const uint32_t *node) {
+    return node + 1 + (((node[0] & FROZEN_COUNT_MASK) + 3u) >> 2);
+}
+
+/* Child index of `ch` in a frozen record, or notFound. Labels are
+ * followed by the child refs, so SIMD over-reads stay inside the record. */
+static inline int FrozenPosition(const uint32_t *node, char ch) {
+    int n = (int)(node[0] & FROZEN_COUNT_MASK);
+    const char *labels = FrozenLabels(node);
+
+    if (n <= TRIE_SIMD_MAX) return LabelIndex(labels, n, ch);
+
+    int lo = 0, hi = n - 1;
+    while (lo <= hi) {
+        int mid = (lo + hi) >> 1;
+        if (labels[mid] == ch) return mid;
+        if (labels[mid] < ch) lo = mid + 1; else hi = mid - 1;
+    }
+    return notFound;
+}
@@ -0,0 +1,311 @@
+#include "TrieNode.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* ================================================================ *
+ * Live trie: copy-on-write inserts + epoch-based reclamation       *
+ *                                                                  *
+ * Readers run the ordinary lock-free lookups on a root they get    *
+ * from LiveTrieReadBegin. The single writer (serialized by a       *
+ * mutex) never modifies memory a reader can reach, except for one  *
+ * pointer-sized store that publishes a finished change:            *
+ *  - new edge on p:      copy p's record with a new edge block     *
+ *                        holding the edge, store the copy into     *
+ *                        p's parent slot (or the root pointer),    *
+ *  - word ends at p:     copy p's record (sharing its edge block)  *
+ *                        with EndOfWord set, publish it the same   *
+ *                        way,                                      *
+ *  - word meets a leaf:  build the split subtree (shared-letter    *
+ *                        chain + two branches) privately and store *
+ *                        it over the leaf's slot.                  *
+ * Plain reader loads of these slots are safe because every         *
+ * pointee is complete before its release store, and loads through  *
+ * a just-read pointer are address-dependent (ordered on every      *
+ * supported CPU).                                                  *
+ *                                                                  *
+ * Replaced records and edge blocks are retired. Each reader        *
+ * announces the epoch it entered in its own slot; a grace period   *
+ * bumps the global epoch and waits until every reader is either    *
+ * outside a section or inside one that began after the bump, and  *
+ * then returns the retired memory to the arena free lists.         *
+ *                                                                  *
+ * The first root version is the arena's embedded root; later       *
+ * versions are ordinary arena records, so the embedded one is      *
+ * never put on a free list.                                        *
+ * ================================================================ */
+
+#define LIVE_RECLAIM_BATCH 256   /* retired items that trigger a grace period */
+
+enum { retiredLeaf, retiredNonLeaf, retiredEdges };
+
+typedef struct {
+    void *ptr;
+    int kind;
+    int cls;                      /* edge class (retiredEdges) */
+} Retired;
+
+struct LiveReader {
+    volatile long active;         /* epoch of the open section, 0 = none */
+    LiveTrie *owner;
+    LiveReader *next;
+    char pad[64];                 /* keep readers' slots on separate lines */
+};
+
+struct LiveTrie {
+    TrieArena *arena;
+    void *volatile root;          /* current root version (NonLeafPtr) */
+    volatile long epoch;          /* >= 1 */
+    TrieMutex *lock;              /* writer + reader list */
+    LiveReader *readers;
+    Retired *retired;
+    int retiredCount, retiredCap;
+};
+
+/* ========================= *
+ * Readers                   *
+ * ========================= */
+
+LiveReader *LiveTrieReaderJoin(LiveTrie *lt) {
+    LiveReader *r = (LiveReader*)calloc(1, sizeof(*r));
+    if (!r) Error("out of memory: LiveTrieReaderJoin");
+    r->owner = lt;
+    TrieMutexLock(lt->lock);
+    r->next = lt->readers;
+    lt->readers = r;
+    TrieMutexUnlock(lt->lock);
+    return r;
+}
+
+void LiveTrieReaderLeave(LiveReader *r) {
+    if (!r) return;
+    LiveTrie *lt = r->owner;
+    TrieMutexLock(lt->lock);
+    LiveReader **link = &lt->readers;
+    while (*link != r) link = &(*link)->next;
+    *link = r->next;
+    TrieMutexUnlock(lt->lock);
+    free(r);
+}
+
+NonLeafPtr LiveTrieReadBegin(LiveReader *r) {
+    /* announce first (sequentially consistent), then read the root: a
+       grace period that misses the announcement bumped the epoch before
+       it, so this section only sees what is still published */
+    TrieAtomicStore(&r->active, TrieAtomicLoad(&r->owner->epoch));
+    return (NonLeafPtr)TrieAtomicLoadPtr(&r->owner->root);
+}
+
+void LiveTrieReadEnd(LiveReader *r) {
+    TrieAtomicStore(&r->active, 0);
+}
+
+/* ========================= *
+ * Reclamation               *
+ * ========================= */
+
+static void Retire(LiveTrie *lt, void *ptr, int kind, int cls) {
+    if (ptr == &lt->arena->root) return;          /* embedded: not a slab record */
+    if (lt->retiredCount == lt->retiredCap) {
+        int cap = lt->retiredCap ? lt->retiredCap * 2 : LIVE_RECLAIM_BATCH;
+        Retired *r = (Retired*)realloc(lt->retired, (size_t)cap * sizeof(Retired));
+        if (!r) Error("out of memory: LiveTrie");
+        lt->retired = r;
+        lt->retiredCap = cap;
+    }
+    Retired *it = &lt->retired[lt->retiredCount++];
+    it->ptr = ptr;
+    it->kind = kind;
+    it->cls = cls;
+}
+
+/* Caller holds the lock. */
+static void Reclaim(LiveTrie *lt) {
+    if (lt->retiredCount == 0) return;
+
+    long epoch = lt->epoch + 1;
+    TrieAtomicStore(&lt->epoch, epoch);
+
+    for (LiveReader *r = lt->readers; r; r = r->next) {
+        for (int spins = 0; ; ++spins) {
+            long seen = TrieAtomicLoad(&r->active);
+            if (seen == 0 || seen == epoch) break;    /* idle, or entered after the bump */
+            if (spins >= 64) TrieYield();
+        }
+    }
+
+    for (int i = 0; i < lt->retiredCount; ++i) {
+        Retired *it = &lt->retired[i];
+        if (it->kind == retiredLeaf)         ArenaFreeLeaf(lt->arena, (LeafPtr)it->ptr);
+        else if (it->kind == retiredNonLeaf) ArenaFreeNonLeaf(lt->arena, (NonLeafPtr)it->ptr);
+        else                                 ArenaFreeEdgeBlock(lt->arena, it->cls, (NonLeafPtr*)it->ptr);
+    }
+    lt->retiredCount = 0;
+}
+
+void LiveTrieSynchronize(LiveTrie *lt) {
+    TrieMutexLock(lt->lock);
+    Reclaim(lt);
+    TrieMutexUnlock(lt->lock);
+}
+
+/* ========================= *
+ * Private construction      *
+ * ========================= */
+
+/* Leaf pointing at `suffix` (suffix bytes are never freed or changed, so
+ * a split may point into the old leaf's suffix instead of copying). */
+static NonLeafPtr NewLeaf(TrieArena *a, const char *suffix, unsigned int weight) {
+    LeafPtr lf = ArenaNewLeaf(a);
+    lf->kind = leaf;
+    lf->weight = weight;
+    lf->word = (char*)suffix;
+    return (NonLeafPtr)lf;
+}
+
+/* Non-leaf with the given (sorted, distinct) edges. */
+static NonLeafPtr NewNonLeaf(TrieArena *a, int n, const char *letters, NonLeafPtr *children) {
+    NonLeafPtr p = ArenaNewNonLeaf(a);
+    p->kind = !leaf;
+    if (n > 0) {
+        p->ptrs = ArenaEdgeBlock(a, EdgeClass(n), &p->letters);
+        memcpy(p->letters, letters, (size_t)n);
+        memcpy(p->ptrs, children, (size_t)n * sizeof(NonLeafPtr));
+        p->count = (unsigned)n;
+    }
+    return p;
+}
+
+/* Copy of p's record with edge ch -> child added, in a new edge block. */
+static NonLeafPtr CopyWithEdge(TrieArena *a, NonLeafPtr p, char ch, NonLeafPtr child) {
+    int len = (int)p->count, stop = 0;
+    while (stop < len && p->letters[stop] < ch) ++stop;
+
+    NonLeafPtr q = ArenaNewNonLeaf(a);
+    *q = *p;
+    int cls = EdgeClass(len + 1);
+    q->ptrs = ArenaEdgeBlock(a, cls, &q->letters);
+    memcpy(q->ptrs, p->ptrs, (size_t)stop * sizeof(NonLeafPtr));
+    memcpy(q->ptrs + stop + 1, p->ptrs + stop, (size_t)(len - stop) * sizeof(NonLeafPtr));
+    memcpy(q->letters, p->letters, (size_t)stop);
+    memcpy(q->letters + stop + 1, p->letters + stop, (size_t)(len - stop));
+    q->letters[stop] = ch;
+    q->ptrs[stop] = child;
+    q->count = (unsigned)(len + 1);
+    if (cls >= TRIE_WIDE_CLASS)
+        for (int i = 0; i <= len; ++i) BitmapSet(EdgeBitmap(q), q->letters[i]);
+    return q;
+}
+
+/* Replacement for leaf `lf` that also holds the word ending in `w` (the
+ * two differ): one single-edge node per shared letter, then a node that
+ * either ends one word and continues the other, or forks in two. */
+static NonLeafPtr SplitLeaf(TrieArena *a, LeafPtr lf, const char *w) {
+    const char *t = lf->word;
+    size_t k = 0;
+    while (t[k] && t[k] == w[k]) ++k;
+
+    NonLeafPtr bottom;
+    if (t[k] == '\0' || w[k] == '\0') {
+        /* one word ends here, the other continues below */
+        int oldEnds = t[k] == '\0';
+        const char *rest = oldEnds ? w + k : t + k;
+        NonLeafPtr child = NewLeaf(a, rest + 1, oldEnds ? 0 : lf->weight);
+        bottom = NewNonLeaf(a, 1, rest, &child);
+        bottom->EndOfWord = yes;
+        bottom->weight = oldEnds ? lf->weight : 0;
+    } else {
+        char letters[2];
+        NonLeafPtr children[2];
+        int oldFirst = t[k] < w[k];
+        letters[!oldFirst] = t[k];
+        children[!oldFirst] = NewLeaf(a, t + k + 1, lf->weight);
+        letters[oldFirst] = w[k];
+        children[oldFirst] = NewLeaf(a, w + k + 1, 0);
+        bottom = NewNonLeaf(a, 2, letters, children);
+    }
+    bottom->maxWeight = lf->weight;
+
+    while (k-- > 0) {
+        bottom = NewNonLeaf(a, 1, t + k, &bottom);
+        bottom->maxWeight = lf->weight;
+    }
+    return bottom;
+}
+
+/* Store `node` where `parent` (NULL: the root pointer) reaches slot pos. */
+static void Publish(LiveTrie *lt, NonLeafPtr parent, int pos, NonLeafPtr node) {
+    if (parent) TrieAtomicStorePtr((void *volatile *)&parent->ptrs[pos], node);
+    else        TrieAtomicStorePtr(&lt->root, node);
+}
+
+/* ========================= *
+ * Writer                    *
+ * ========================= */
+
+LiveTrie *LiveTrieCreate(NonLeafPtr root) {
+    LiveTrie *lt = (LiveTrie*)calloc(1, sizeof(*lt));
+    if (!lt) Error("out of memory: LiveTrieCreate");
+    lt->arena = ArenaOf(root);
+    lt->root = root;
+    lt->epoch = 1;
+    lt->lock = TrieMutexCreate();
+    return lt;
+}
+
+void LiveTrieDestroy(LiveTrie *lt) {
+    if (!lt) return;
+    ArenaDestroy(lt->arena);                      /* retired memory lives there too */
+    TrieMutexDestroy(lt->lock);
+    free(lt->retired);
+    free(lt);
+}
+
+void LiveTrieInsert(LiveTrie *lt, const char *upper_word) {
+    TrieMutexLock(lt->lock);
+
+    TrieArena *a = lt->arena;
+    NonLeafPtr p = (NonLeafPtr)lt->root, parent = NULL;
+    const char *w = upper_word;
+    int ppos = 0;
+
+    while (1) {
+        if (*w == '\0') {
+            if (p->EndOfWord != yes) {
+                NonLeafPtr q = ArenaNewNonLeaf(a);
+                *q = *p;                              /* shares p's edge block */
+                q->EndOfWord = yes;
+                Publish(lt, parent, ppos, q);
+                Retire(lt, p, retiredNonLeaf, 0);
+            }
+            break;
+        }
+
+        int pos = Position(p, *w);
+        if (pos == notFound) {
+            NonLeafPtr q = CopyWithEdge(a, p, *w, NewLeaf(a, ArenaSuffix(a, w + 1, strlen(w + 1)), 0));
+            Publish(lt, parent, ppos, q);
+            if (p->count > 0) Retire(lt, p->ptrs, retiredEdges, EdgeClass((int)p->count));
+            Retire(lt, p, retiredNonLeaf, 0);
+            break;
+        }
+
+        NonLeafPtr child = p->ptrs[pos];
+        if (child->kind == leaf) {
+            LeafPtr lf = (LeafPtr)child;
+            if (strcmp(lf->word, w + 1) != 0) {
+                const char *tail = ArenaSuffix(a, w + 1, strlen(w + 1));
+                Publish(lt, p, pos, SplitLeaf(a, lf, tail));
+                Retire(lt, lf, retiredLeaf, 0);
+            }
+            break;
+        }
+
+        parent = p;
+        ppos = pos;
+        p = child;
+        ++w;
+    }
+
+    if (lt->retiredCount >= LIVE_RECLAIM_BATCH) Reclaim(lt);
+    TrieMutexUnlock(lt->lock);
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include "TrieArena.h"
+#include "TriePlatform.h"
+#include <limits.h>
+
+/* ================================================================ *
+ * Non-leaf edge lookup (library-private)                           *
+ *                                                                  *
+ * A non-leaf keeps `count` edges in letters[0..count-1] (sorted,   *
+ * not NUL-terminated) with children in ptrs[0..count-1]. Both live *
+ * in one arena edge block of capacity 1 << EdgeClass(count).       *
+ *                                                                  *
+ * Position() picks its strategy by fan-out:                        *
+ *  - count <= 8:   plain scan with early exit on the sorted labels,*
+ *  - count <= 32:  SSE2 compare + movemask over 16 or 32 labels,   *
+ *  - count >  32:  256-bit presence bitmap stored right in front   *
+ *                  of `ptrs`; the child index is the popcount of   *
+ *                  the bits below the label (rank).                *
+ * The bitmap exists only for edge classes >= TRIE_WIDE_CLASS. For  *
+ * an A-Z root (<= 32 edges) the two 16-byte compares measured      *
+ * faster than the popcount rank; wider alphabets use the bitmap.   *
+ * ================================================================ */
+
+#define TRIE_SCAN_MAX    8       /* fan-out handled by the scalar scan */
+#define TRIE_SIMD_MAX    32      /* fan-out handled by SIMD compares */
+
+/* Bitmap key of a label. Labels are sorted as `char`, so on signed-char
+ * targets we flip the top bit to make bit order match label order. */
+#if CHAR_MIN < 0
+#define EDGE_KEY(ch) ((unsigned)(unsigned char)(ch) ^ 0x80u)
+#else
+#define EDGE_KEY(ch) ((unsigned)(unsigned char)(ch))
+#endif
+
+#define EdgeBitmap(p) ((uint64_t*)(p)->ptrs - 4)
+
+static inline void BitmapSet(uint64_t *bm, char ch) {
+    unsigned k = EDGE_KEY(ch);
+    bm[k >> 6] |= (uint64_t)1 << (k & 63);
+}
+
+static inline void BitmapClear(uint64_t *bm, char ch) {
+    unsigned k = EDGE_KEY(ch);
+    bm[k >> 6] &= ~((uint64_t)1 << (k & 63));
+}
+
+/* Index of `ch` among `n` sorted labels (n <= TRIE_SIMD_MAX), or notFound.
+ * For n > TRIE_SCAN_MAX the SSE2 path loads 16 (n <= 16) or 32 bytes from
+ * `labels`; callers guarantee that many readable bytes. */
+static inline int LabelIndex(const char *labels, int n, char ch) {
+    if (n <= TRIE_SCAN_MAX) {
+        for (int i = 0; i < n; ++i) {
+            if (labels[i] == ch) return i;
+            if (labels[i] > ch) break;         /* sorted: cannot appear later */
+        }
+        return notFound;
+    }
+#if TRIE_HAVE_SSE2
+    {
+        __m128i key = _mm_set1_epi8(ch);
+        uint32_t m = (uint32_t)_mm_movemask_epi8(
+            _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)labels), key));
+        if (n > 16)
+            m |= (uint32_t)_mm_movemask_epi8(
+                _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(labels + 16)), key)) << 16;
+        if (n < 32) m &= (1u << n) - 1u;
+        return m ? TrieCtz32(m) : notFound;
+    }
+#else
+    for (int i = 0; i < n; ++i)
+        if (labels[i] == ch) return i;
+    return notFound;
+#endif
+}
+
+/* Find position of `ch` among p's edges. Returns index or notFound.
+ * Edge blocks with count > 8 hold >= 16 (class 4) or 32 label bytes. */
+static inline int Position(NonLeafPtr p, char ch) {
+    int n = (int)p->count;
+
+    if (n <= TRIE_SIMD_MAX) return LabelIndex(p->letters, n, ch);
+
+    {
+        const uint64_t *bm = EdgeBitmap(p);
+        unsigned k = EDGE_KEY(ch), w = k >> 6;
+        uint64_t below = ((uint64_t)1 << (k & 63)) - 1u;
+
+        if (!(bm[w] & ((uint64_t)1 << (k & 63)))) return notFound;
+        int rank = TriePopcount64(bm[w] & below);
+        for (unsigned i = 0; i < w; ++i) rank += TriePopcount64(bm[i]);
+        return rank;
+    }
+}
+
+/* Hot-path counters (TrieStats.c); compiled out unless TRIE_COUNTERS=1. */
+#if defined(TRIE_COUNTERS) && TRIE_COUNTERS
+extern TRIE_THREAD_LOCAL TrieCounters trieCounters;
+#define TRIE_COUNT(field, n) (trieCounters.field += (n))
+#else
+#define TRIE_COUNT(field, n) ((void)0)
+#endif
@@ -0,0 +1,578 @@
+#include "TrieNode.h"
+#include "TrieSuggest.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+/* ================================================================ *
+ * Packed (mutable) radix trie                                      *
+ *                                                                  *
+ * Same words and leaves as the pointer trie, but every node is ONE *
+ * variable-length record in a single uint32 pool, children are     *
+ * 32-bit word indices into it, and chains of single-edge nodes are *
+ * folded into the record below them (radix / Patricia style):      *
+ *                                                                  *
+ *   non-leaf: [hdr][labels: cap bytes, padded][children: cap u32]  *
+ *             [prefix bytes, padded]                               *
+ *   leaf:     [hdr][suffix bytes + NUL, zero-padded]               *
+ *                                                                  *
+ *   hdr bit 0     PACKED_LEAF                                      *
+ *       bit 1     PACKED_EOW (non-leaf)                            *
+ *       non-leaf: bits 2..10 edge count, bits 11..14 class         *
+ *                 (capacity 1 << class, as EdgeClass),             *
+ *                 bits 15..31 prefix length                        *
+ *       leaf:     bits 2..31 suffix length                         *
+ *                                                                  *
+ * A non-leaf reached over edge `c` first has to match its prefix;  *
+ * its end-of-word flag and edges apply after the prefix. A prefix  *
+ * of length m stands for m single-edge, non-word nodes of the      *
+ * pointer trie, so a lookup through INTERNATIONAL... visits one    *
+ * record per branching point instead of one per letter. The root   *
+ * never has a prefix.                                              *
+ *                                                                  *
+ * A lookup step touches one record: labels and child indices sit   *
+ * right behind the header, and a leaf's tail is inline. The prefix *
+ * goes last, so the offsets a lookup computes on its way down      *
+ * depend on the class alone (prefix-first measured ~15% slower on  *
+ * a dictionary with few chains). Capacities round up to a power of *
+ * two like edge blocks, which keeps the SSE2 reads of LabelIndex   *
+ * in bounds and makes regrowth amortized.                          *
+ *                                                                  *
+ * Inserts relocate a record whenever it outgrows its class, its    *
+ * prefix is split or a leaf splits; the old record goes to a free  *
+ * list keyed by its size in words. The pool itself may move on     *
+ * growth, so the code holds indices, never pointers, across an     *
+ * allocation. Word 0 is unused, so index 0 terminates the lists.   *
+ * ================================================================ */
+
+#define PACKED_LEAF         0x1u
+#define PACKED_EOW          0x2u
+#define PACKED_COUNT(h)     (((h) >> 2) & 0x1ffu)
+#define PACKED_CLASS(h)     ((int)(((h) >> 11) & 0xfu))
+#define PACKED_SKIP(h)      ((h) >> 15)
+#define PACKED_LEN(h)       ((h) >> 2)
+#define PACKED_MAX_LEN      0x3fffffffu
+#define PACKED_MAX_SKIP     0x1ffffu
+
+#define PACKED_FREE_WORDS   512      /* free lists for records below this size */
+#define PACKED_FIRST_WORDS  (16u * 1024u)
+
+struct PackedTrie {
+    uint32_t *pool;               /* records; pool[0] is unused */
+    uint32_t used;                /* words handed out (free records included) */
+    uint32_t cap;                 /* words allocated */
+    uint32_t root;                /* index of the root record (it moves too) */
+    uint32_t freeHead[PACKED_FREE_WORDS];
+};
+
+static uint32_t ByteWords(size_t n)   { return (uint32_t)((n + 3u) >> 2); }
+static uint32_t LeafWords(size_t len) { return 1u + ByteWords(len + 1); }
+
+static uint32_t NonLeafWords(int cls, uint32_t skip) {
+    return 1u + ByteWords(skip) + ByteWords(1u << cls) + (1u << cls);
+}
+
+/* Record parts. They take a const pool like strchr does; the insert
+ * path writes through the results. */
+static char *Suffix(const uint32_t *pool, uint32_t r) { return (char*)(pool + r + 1); }
+static char *Labels(const uint32_t *pool, uint32_t r) { return (char*)(pool + r + 1); }
+
+static uint32_t *Children(const uint32_t *pool, uint32_t r) {
+    return (uint32_t*)(pool + r + 1 + ByteWords(1u << PACKED_CLASS(pool[r])));
+}
+
+static char *Prefix(const uint32_t *pool, uint32_t r) {
+    uint32_t cap = 1u << PACKED_CLASS(pool[r]);
+    return (char*)(pool + r + 1 + ByteWords(cap) + cap);
+}
+
+/* ========================= *
+ * Pool                      *
+ * ========================= */
+
+static uint32_t Alloc(PackedTrie *pt, uint32_t words) {
+    if (words < PACKED_FREE_WORDS && pt->freeHead[words]) {
+        uint32_t r = pt->freeHead[words];
+        pt->freeHead[words] = pt->pool[r + 1];
+        return r;
+    }
+    if (pt->cap - pt->used < words) {
+        size_t cap = (size_t)pt->cap + pt->cap / 2 + words;
+        if (cap > UINT32_MAX) cap = UINT32_MAX;
+        if (cap - pt->used < words) Error("packed trie: pool exceeds 2^32 words");
+        uint32_t *pool = (uint32_t*)realloc(pt->pool, cap * sizeof(uint32_t));
+        if (!pool) Error("out of memory: PackedTrie pool");
+        pt->pool = pool;
+        pt->cap = (uint32_t)cap;
+    }
+    uint32_t r = pt->used;
+    pt->used += words;
+    return r;
+}
+
+static void Release(PackedTrie *pt, uint32_t r, uint32_t words) {
+    if (words >= PACKED_FREE_WORDS) return;   /* long prefixes/suffixes: left as garbage */
+    pt->pool[r + 1] = pt->freeHead[words];
+    pt->freeHead[words] = r;
+}
+
+static void ReleaseNonLeaf(PackedTrie *pt, uint32_t r) {
+    uint32_t h = pt->pool[r];
+    Release(pt, r, NonLeafWords(PACKED_CLASS(h), PACKED_SKIP(h)));
+}
+
+/* Empty non-leaf; `prefix` must not point into the pool (Alloc may move
+ * it), NULL leaves the prefix bytes for the caller to fill. */
+static uint32_t NewNonLeaf(PackedTrie *pt, int cls, uint32_t flags, const char *prefix, size_t skip) {
+    uint32_t words = NonLeafWords(cls, (uint32_t)skip);
+    uint32_t r = Alloc(pt, words);
+    memset(pt->pool + r, 0, words * sizeof(uint32_t));
+    pt->pool[r] = ((uint32_t)skip << 15) | ((uint32_t)cls << 11) | flags;
+    if (prefix) memcpy(Prefix(pt->pool, r), prefix, skip);
+    return r;
+}
+
+/* `s` must not point into the pool either. */
+static uint32_t NewLeaf(PackedTrie *pt, const char *s, size_t len) {
+    if (len > PACKED_MAX_LEN) Error("packed trie: word too long");
+    uint32_t words = LeafWords(len);
+    uint32_t r = Alloc(pt, words);
+    pt->pool[r + words - 1] = 0;              /* NUL + padding */
+    pt->pool[r] = ((uint32_t)len << 2) | PACKED_LEAF;
+    memcpy(Suffix(pt->pool, r), s, len);
+    return r;
+}
+
+/* Copy of non-leaf r with capacity class `cls` and only the prefix bytes
+ * from `from` on; r is released. */
+static uint32_t Relocate(PackedTrie *pt, uint32_t r, int cls, uint32_t from) {
+    uint32_t h = pt->pool[r];
+    uint32_t skip = PACKED_SKIP(h) - from;
+    int n = (int)PACKED_COUNT(h);
+    uint32_t dst = NewNonLeaf(pt, cls, h & PACKED_EOW, NULL, skip);
+    uint32_t *pool = pt->pool;
+
+    memcpy(Prefix(pool, dst), Prefix(pool, r) + from, skip);
+    memcpy(Labels(pool, dst), Labels(pool, r), (size_t)n);
+    memcpy(Children(pool, dst), Children(pool, r), (size_t)n * sizeof(uint32_t));
+    pool[dst] |= (uint32_t)n << 2;
+    ReleaseNonLeaf(pt, r);
+    return dst;
+}
+
+/* Insert edge (ch -> child) at `pos` of non-leaf r; returns the record's
+ * (possibly new) index. */
+static uint32_t AddEdge(PackedTrie *pt, uint32_t r, int pos, char ch, uint32_t child) {
+    uint32_t h = pt->pool[r];
+    int n = (int)PACKED_COUNT(h), cls = PACKED_CLASS(h);
+
+    if (n == (1 << cls)) r = Relocate(pt, r, cls + 1, 0);
+
+    uint32_t *pool = pt->pool;
+    char *labels = Labels(pool, r);
+    uint32_t *kids = Children(pool, r);
+    memmove(labels + pos + 1, labels + pos, (size_t)(n - pos));
+    memmove(kids + pos + 1, kids + pos, (size_t)(n - pos) * sizeof(uint32_t));
+    labels[pos] = ch;
+    kids[pos] = child;
+    pool[r] = (pool[r] & ~(0x1ffu << 2)) | ((uint32_t)(n + 1) << 2);
+    return r;
+}
+
+/* Index of `ch` among `n` sorted labels, or notFound. */
+static int FindLabel(const char *labels, int n, char ch) {
+    if (n <= TRIE_SIMD_MAX) return LabelIndex(labels, n, ch);
+
+    int lo = 0, hi = n - 1;
+    while (lo <= hi) {
+        int mid = (lo + hi) >> 1;
+        if (labels[mid] == ch) return mid;
+        if (labels[mid] < ch) lo = mid + 1; else hi = mid - 1;
+    }
+    return notFound;
+}
+
+static int Find(const uint32_t *pool, uint32_t r, char ch) {
+    return FindLabel(Labels(pool, r), (int)PACKED_COUNT(pool[r]), ch);
+}
+
+/* Two-leaf fork (or end-of-word + one leaf if either tail is empty) under
+ * a prefix: the subtree holding tails a and b, which differ at their first
+ * byte. Neither string may point into the pool. */
+static uint32_t Fork(PackedTrie *pt, const char *prefix, size_t skip, const char *a, const char *b) {
+    uint32_t r;
+    if (a[0] == '\0' || b[0] == '\0') {
+        const char *longer = a[0] ? a : b;
+        uint32_t lf = NewLeaf(pt, longer + 1, strlen(longer + 1));
+        r = NewNonLeaf(pt, 0, PACKED_EOW, prefix, skip);
+        return AddEdge(pt, r, 0, longer[0], lf);
+    }
+    if (b[0] < a[0]) { const char *t = a; a = b; b = t; }
+    uint32_t la = NewLeaf(pt, a + 1, strlen(a + 1));
+    uint32_t lb = NewLeaf(pt, b + 1, strlen(b + 1));
+    r = NewNonLeaf(pt, 1, 0, prefix, skip);
+    r = AddEdge(pt, r, 0, a[0], la);
+    return AddEdge(pt, r, 1, b[0], lb);
+}
+
+/* ========================= *
+ * Splits                    *
+ * ========================= *
+ * Leaf split: leaf tail t meets word tail w below the same edge. The  *
+ * shared part becomes the prefix of the new fork (or of a chain of    *
+ * records, if it exceeds PACKED_MAX_SKIP).                            */
+
+static uint32_t SplitLeaf(PackedTrie *pt, const char *t, const char *w) {
+    size_t k = 0;
+    while (t[k] && t[k] == w[k]) ++k;
+
+    size_t start = k > PACKED_MAX_SKIP ? k - PACKED_MAX_SKIP : 0;
+    uint32_t bottom = Fork(pt, t + start, k - start, t + k, w + k);
+
+    while (start > 0) {
+        size_t end = start - 1;               /* t[end] labels the edge down */
+        start = end > PACKED_MAX_SKIP ? end - PACKED_MAX_SKIP : 0;
+        uint32_t up = NewNonLeaf(pt, 0, 0, t + start, end - start);
+        bottom = AddEdge(pt, up, 0, t[end], bottom);
+    }
+    return bottom;
+}
+
+/* Prefix split: word tail w leaves the prefix of non-leaf r after k
+ * matching bytes. r keeps the bytes past the mismatch; above it a new
+ * record with the first k bytes gets end-of-word (w ended) or a second
+ * edge to a leaf for the rest of w. Returns the new record. */
+static uint32_t SplitPrefix(PackedTrie *pt, uint32_t r, size_t k, const char *w) {
+    char small[64];
+    char *head = k + 1 <= sizeof(small) ? small : (char*)malloc(k + 1);
+    if (!head) Error("out of memory: PackedTrieInsert");
+    memcpy(head, Prefix(pt->pool, r), k + 1); /* shared bytes + the edge label to r */
+
+    char label = head[k];
+    uint32_t rest = Relocate(pt, r, PACKED_CLASS(pt->pool[r]), (uint32_t)k + 1);
+    uint32_t top;
+
+    if (w[k] == '\0') {
+        top = NewNonLeaf(pt, 0, PACKED_EOW, head, k);
+        top = AddEdge(pt, top, 0, label, rest);
+    } else {
+        uint32_t lf = NewLeaf(pt, w + k + 1, strlen(w + k + 1));
+        int wFirst = w[k] < label;
+        top = NewNonLeaf(pt, 1, 0, head, k);
+        top = AddEdge(pt, top, 0, wFirst ? w[k] : label, wFirst ? lf : rest);
+        top = AddEdge(pt, top, 1, wFirst ? label : w[k], wFirst ? rest : lf);
+    }
+    if (head != small) free(head);
+    return top;
+}
+
+/* ========================= *
+ * Public API                *
+ * ========================= */
+
+PackedTrie *PackedTrieCreate(void) {
+    PackedTrie *pt = (PackedTrie*)calloc(1, sizeof(PackedTrie));
+    if (!pt) Error("out of memory: PackedTrieCreate");
+    pt->pool = (uint32_t*)malloc(PACKED_FIRST_WORDS * sizeof(uint32_t));
+    if (!pt->pool) Error("out of memory: PackedTrieCreate");
+    pt->cap = PACKED_FIRST_WORDS;
+    pt->used = 1;                             /* index 0 means "none" */
+    pt->root = NewNonLeaf(pt, 0, 0, NULL, 0);
+    return pt;
+}
+
+void PackedTrieDestroy(PackedTrie *pt) {
+    if (!pt) return;
+    free(pt->pool);
+    free(pt);
+}
+
+void PackedTrieInsert(PackedTrie *pt, const char *upper_word) {
+    const char *w = upper_word;
+    uint32_t r = pt->root;
+    uint32_t parent = 0;                      /* 0: r is the root */
+    int slot = 0;                             /* edge of `parent` leading to r */
+
+    while (1) {
+        uint32_t *pool = pt->pool;
+        size_t skip = PACKED_SKIP(pool[r]);
+        if (skip) {
+            const char *p = Prefix(pool, r);
+            size_t k = 0;
+            while (k < skip && w[k] == p[k]) ++k;
+            if (k < skip) {                   /* never at the root: it has no prefix */
+                uint32_t top = SplitPrefix(pt, r, k, w);
+                Children(pt->pool, parent)[slot] = top;
+                return;
+            }
+            w += skip;
+        }
+        if (*w == '\0') break;
+
+        int pos = Find(pool, r, *w);
+        if (pos == notFound) {
+            int n = (int)PACKED_COUNT(pool[r]);
+            const char *labels = Labels(pool, r);
+            pos = 0;
+            while (pos < n && labels[pos] < *w) ++pos;
+
+            uint32_t lf = NewLeaf(pt, w + 1, strlen(w + 1));
+            uint32_t moved = AddEdge(pt, r, pos, *w, lf);
+            if (moved != r) {
+                if (parent) Children(pt->pool, parent)[slot] = moved;
+                else        pt->root = moved;
+            }
+            return;
+        }
+
+        uint32_t c = Children(pool, r)[pos];
+        if (pool[c] & PACKED_LEAF) {
+            const char *t = Suffix(pool, c);
+            if (strcmp(t, w + 1) == 0) return;    /* already present */
+
+            /* the split allocates, so work on a copy of the old suffix */
+            size_t tl = PACKED_LEN(pool[c]);
+            char small[64];
+            char *copy = tl < sizeof(small) ? small : (char*)malloc(tl + 1);
+            if (!copy) Error("out of memory: PackedTrieInsert");
+            memcpy(copy, t, tl + 1);
+
+            uint32_t sub = SplitLeaf(pt, copy, w + 1);
+            Children(pt->pool, r)[pos] = sub;
+            Release(pt, c, LeafWords(tl));
+            if (copy != small) free(copy);
+            return;
+        }
+
+        parent = r;
+        slot = pos;
+        r = c;
+        ++w;
+    }
+    pt->pool[r] |= PACKED_EOW;
+}
+
+int SearchPacked(const PackedTrie *pt, const char *word) {
+    const uint32_t *pool = pt->pool;
+    uint32_t r = pt->root;
+
+    while (1) {
+        uint32_t h = pool[r];
+        if (h & PACKED_LEAF)
+            return strcmp(word, Suffix(pool, r)) == 0 ? success : !success;
+
+        uint32_t skip = PACKED_SKIP(h);
+        if (skip) {
+            const char *p = Prefix(pool, r);
+            for (uint32_t i = 0; i < skip; ++i)
+                if (word[i] != p[i]) return !success;   /* also stops at the word's NUL */
+            word += skip;
+        }
+        if (*word == '\0')
+            return (h & PACKED_EOW) ? success : !success;
+
+        const uint32_t *rec = pool + r + 1;   /* labels, then children */
+        int pos = FindLabel((const char*)rec, (int)PACKED_COUNT(h), *word);
+        if (pos == notFound) return !success;
+        r = rec[ByteWords(1u << PACKED_CLASS(h)) + (uint32_t)pos];
+        ++word;
+    }
+}
+
+size_t PackedTrieBytes(const PackedTrie *pt) {
+    return sizeof(PackedTrie) + (size_t)pt->cap * sizeof(uint32_t);
+}
+
+void PackedTrieTrim(PackedTrie *pt) {
+    uint32_t *pool = (uint32_t*)realloc(pt->pool, (size_t)pt->used * sizeof(uint32_t));
+    if (!pool) return;                        /* keep the larger block */
+    pt->pool = pool;
+    pt->cap = pt->used;
+}
+
+/* ========================= *
+ * Suggestions (Damerau-1)   *
+ * ========================= *
+ * The DFS runs on the unfolded trie: a cursor (record, offset) with   *
+ * offset < prefix length is a single-edge, non-word node whose edge   *
+ * is the next prefix byte. That reproduces dfsSuggest node for node,  *
+ * so both return identical lists. Once the edit is spent only exact   *
+ * matches remain, and the rest of a prefix is compared in one go.     */
+
+typedef struct {
+    uint32_t r;                   /* non-leaf record */
+    uint32_t off;                 /* prefix bytes already consumed */
+} Cursor;
+
+/* The unfolded node at a cursor, decoded once per visit. */
+typedef struct {
+    const char *labels;
+    const uint32_t *kids;         /* NULL inside a prefix */
+    int n;
+    int word;                     /* end of word here */
+} View;
+
+static View Decode(const uint32_t *pool, Cursor v) {
+    uint32_t h = pool[v.r];
+    View x;
+    if (v.off < PACKED_SKIP(h)) {
+        x.labels = Prefix(pool, v.r) + v.off;
+        x.kids = NULL;
+        x.n = 1;
+        x.word = 0;
+    } else {
+        x.labels = Labels(pool, v.r);
+        x.kids = Children(pool, v.r);
+        x.n = (int)PACKED_COUNT(h);
+        x.word = (h & PACKED_EOW) != 0;
+    }
+    return x;
+}
+
+/* Follow edge i of v: returns the leaf suffix it leads to, or NULL and
+ * the child cursor in *child. Only called for edges the DFS takes, so
+ * skipped children are never loaded. */
+static const char *Descend(const uint32_t *pool, Cursor v, const View *x, int i, Cursor *child) {
+    if (!x->kids) {
+        child->r = v.r;
+        child->off = v.off + 1;
+        return NULL;
+    }
+    uint32_t c = x->kids[i];
+    if (pool[c] & PACKED_LEAF) return Suffix(pool, c);
+    child->r = c;
+    child->off = 0;
+    return NULL;
+}
+
+static void dfsPacked(const uint32_t *pool, Cursor v, const char *in, int idx,
+                      char *prefix, int plen, int edits_used,
+                      SuggestResult *out, int MAX_SUGG) {
+    if (out->count >= MAX_SUGG) return;
+
+    uint32_t skip = PACKED_SKIP(pool[v.r]);
+    if (edits_used && v.off < skip) {
+        uint32_t m = skip - v.off;
+        if (strncmp(in + idx, Prefix(pool, v.r) + v.off, m) != 0) return;
+        memcpy(prefix + plen, Prefix(pool, v.r) + v.off, m);
+        idx += (int)m;
+        plen += (int)m;
+        v.off = skip;
+    }
+    View x = Decode(pool, v);
+
+    if (in[idx] == '\0' && x.word) {
+        prefix[plen] = '\0';
+        ResultAddWord(out, prefix, "");
+        if (out->count >= MAX_SUGG) return;
+    }
+
+    /* Insertion (extra input char): consume in[idx] and stay on this node. */
+    if (edits_used == 0 && in[idx] != '\0') {
+        dfsPacked(pool, v, in, idx + 1, prefix, plen, 1, out, MAX_SUGG);
+        if (out->count >= MAX_SUGG) return;
+    }
+
+    for (int i = 0; i < x.n && out->count < MAX_SUGG; ++i) {
+        char edge = x.labels[i];
+        if (edits_used != 0 && in[idx] != edge) continue;   /* nothing left but exact matches */
+
+        Cursor child;
+        const char *suffix = Descend(pool, v, &x, i, &child);
+
+        /* exact match */
+        if (in[idx] != '\0' && in[idx] == edge) {
+            prefix[plen] = edge; prefix[plen + 1] = '\0';
+            if (suffix) {
+                if (TailWithinOneEdit(suffix, in + idx + 1, edits_used))
+                    ResultAddWord(out, prefix, suffix);
+            } else {
+                dfsPacked(pool, child, in, idx + 1, prefix, plen + 1, edits_used, out, MAX_SUGG);
+            }
+            if (out->count >= MAX_SUGG) return;
+        }
+
+        /* substitution */
+        if (edits_used == 0 && in[idx] != '\0' && in[idx] != edge) {
+            prefix[plen] = edge; prefix[plen + 1] = '\0';
+            if (suffix) {
+                if (TailWithinOneEdit(suffix, in + idx + 1, 1))
+                    ResultAddWord(out, prefix, suffix);
+            } else {
+                dfsPacked(pool, child, in, idx + 1, prefix, plen + 1, 1, out, MAX_SUGG);
+            }
+            if (out->count >= MAX_SUGG) return;
+        }
+
+        /* deletion: go down without consuming input */
+        if (edits_used == 0) {
+            prefix[plen] = edge; prefix[plen + 1] = '\0';
+            if (suffix) {
+                if (TailWithinOneEdit(suffix, in + idx, 1))
+                    ResultAddWord(out, prefix, suffix);
+            } else {
+                dfsPacked(pool, child, in, idx, prefix, plen + 1, 1, out, MAX_SUGG);
+            }
+            if (out->count >= MAX_SUGG) return;
+        }
+    }
+
+    /* adjacent transposition: consume in[idx+1] first, then in[idx] */
+    if (edits_used == 0 && in[idx] != '\0' && in[idx + 1] != '\0') {
+        int pos1 = FindLabel(x.labels, x.n, in[idx + 1]);
+        if (pos1 != notFound) {
+            Cursor c1;
+            const char *s1 = Descend(pool, v, &x, pos1, &c1);
+
+            prefix[plen] = in[idx + 1]; prefix[plen + 1] = '\0';
+
+            if (s1) {
+                if (s1[0] == in[idx]) {
+                    if (TailWithinOneEdit(s1 + 1, in + idx + 2, 1))
+                        ResultAddWord(out, prefix, s1);
+                }
+            } else {
+                View x1 = Decode(pool, c1);
+                int pos2 = FindLabel(x1.labels, x1.n, in[idx]);
+                if (pos2 != notFound) {
+                    Cursor c2;
+                    const char *s2 = Descend(pool, c1, &x1, pos2, &c2);
+
+                    prefix[plen + 1] = in[idx]; prefix[plen + 2] = '\0';
+
+                    if (s2) {
+                        if (TailWithinOneEdit(s2, in + idx + 2, 1))
+                            ResultAddWord(out, prefix, s2);
+                    } else {
+                        dfsPacked(pool, c2, in, idx + 2, prefix, plen + 2, 1, out, MAX_SUGG);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void SuggestCorrectionsPackedInto(const PackedTrie *pt, const char *upper_word,
+                                  int maxSuggestions, SuggestResult *out) {
+    ResultReset(out, maxSuggestions);
+
+    char small[256];
+    char *prefix = SuggestPrefixBuffer(small, sizeof(small), upper_word);
+
+    Cursor root;
+    root.r = pt->root;
+    root.off = 0;
+    dfsPacked(pt->pool, root, upper_word, 0, prefix, 0, 0, out, out->cap);
+    SuggestPrefixFree(prefix, small);
+}
+
+void SuggestCorrectionsPacked(const PackedTrie *pt, const char *upper_word,
+                              int maxSuggestions, SuggestBox *outBox) {
+    if (!SuggestBoxInit(outBox, maxSuggestions)) return;
+
+    SuggestResult r;
+    SuggestResultInit(&r);
+    SuggestCorrectionsPackedInto(pt, upper_word, maxSuggestions, &r);
+    ResultToBox(&r, outBox);
+    SuggestResultFree(&r);
+}
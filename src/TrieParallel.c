@@ -0,0 +1,120 @@
+#include "TrieNode.h"
+#include "TriePlatform.h"
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ================================================================ *
+ * Parallel build, sharded by first byte                            *
+ *                                                                  *
+ * Below the root, the subtrie of each first byte depends only on   *
+ * the words starting with that byte. The input is partitioned by   *
+ * first byte (a stable counting sort of word indices), and the     *
+ * shards, largest first, are claimed by workers through an atomic  *
+ * counter. Each worker inserts its shards with TrieInsert into a   *
+ * trie of its own, in its own arena, so workers share neither      *
+ * nodes nor an allocator.                                          *
+ *                                                                  *
+ * The root is then built in one step: its edge block is sized for  *
+ * the shard count up front and takes each shard's subtrie from the *
+ * worker that built it, in edge order. Finally the worker arenas   *
+ * are merged into the root's (chunk lists are spliced, nothing is  *
+ * copied). The shape of a trie does not depend on insertion order, *
+ * so the result is node for node the trie of the serial            *
+ * TrieCreateWithFirstWord + TrieInsert loop.                       *
+ * ================================================================ */
+
+typedef struct {
+    const char **words;
+    size_t *order;                /* word indices grouped by first byte, input order within */
+    size_t first[257];            /* shard b: order[first[b]..first[b + 1]) */
+    unsigned char shards[256];    /* non-empty shards, largest first */
+    long nShards;
+    volatile long next;           /* next unclaimed shard */
+    TrieArena **arenas;           /* per worker, created on its first shard */
+    int owner[256];               /* worker that built each shard */
+} BuildJob;
+
+static size_t ShardSize(const BuildJob *job, unsigned char b) {
+    return job->first[b + 1] - job->first[b];
+}
+
+static void BuildWorker(void *ctx, int idx) {
+    BuildJob *job = (BuildJob*)ctx;
+
+    long k;
+    while ((k = TrieAtomicFetchAdd(&job->next, 1)) < job->nShards) {
+        unsigned char b = job->shards[k];
+        if (!job->arenas[idx]) job->arenas[idx] = ArenaCreate();
+        NonLeafPtr root = &job->arenas[idx]->root;
+        for (size_t i = job->first[b]; i < job->first[b + 1]; ++i)
+            TrieInsert((char*)job->words[job->order[i]], root);
+        job->owner[b] = idx;
+    }
+}
+
+NonLeafPtr TrieBuildParallel(const char **words, size_t n, int threads) {
+    if (n == 0) return NULL;
+    if (threads <= 0) threads = TrieCpuCount();
+
+    BuildJob job;
+    memset(&job, 0, sizeof(job));
+    job.words = words;
+    job.order = (size_t*)malloc(n * sizeof(size_t));
+    if (!job.order) Error("out of memory: TrieBuildParallel");
+
+    /* partition by first byte; "" (shard 0) only marks the root */
+    size_t at[256];
+    for (size_t i = 0; i < n; ++i) ++job.first[(unsigned char)words[i][0] + 1];
+    for (int b = 0; b < 256; ++b) job.first[b + 1] += job.first[b];
+    memcpy(at, job.first, sizeof(at));
+    for (size_t i = 0; i < n; ++i) job.order[at[(unsigned char)words[i][0]]++] = i;
+
+    for (int b = 1; b < 256; ++b) {
+        if (ShardSize(&job, (unsigned char)b) == 0) continue;
+        long k = job.nShards++;
+        while (k > 0 && ShardSize(&job, job.shards[k - 1]) < ShardSize(&job, (unsigned char)b)) {
+            job.shards[k] = job.shards[k - 1];
+            --k;
+        }
+        job.shards[k] = (unsigned char)b;
+    }
+
+    if (threads > job.nShards) threads = job.nShards > 0 ? (int)job.nShards : 1;
+    job.arenas = (TrieArena**)calloc((size_t)threads, sizeof(TrieArena*));
+    if (!job.arenas) Error("out of memory: TrieBuildParallel");
+    TrieRunThreads(threads, BuildWorker, &job);
+
+    /* the root in one step: each edge points at a worker's subtrie */
+    TrieArena *a = ArenaCreate();
+    NonLeafPtr root = &a->root;
+    if (ShardSize(&job, 0) > 0) root->EndOfWord = yes;
+    if (job.nShards > 0) {
+        int cls = EdgeClass((int)job.nShards);
+        char *letters;
+        root->ptrs = ArenaEdgeBlock(a, cls, &letters);
+        root->letters = letters;
+        root->count = (unsigned)job.nShards;
+
+        int e = 0;
+        for (int v = CHAR_MIN; v <= CHAR_MAX; ++v) {      /* edge order is `char` order */
+            char ch = (char)v;
+            unsigned char b = (unsigned char)ch;
+            if (b == 0 || ShardSize(&job, b) == 0) continue;
+            NonLeafPtr from = &job.arenas[job.owner[b]]->root;
+            root->letters[e] = ch;
+            root->ptrs[e++] = from->ptrs[Position(from, ch)];
+            if (cls >= TRIE_WIDE_CLASS) BitmapSet(EdgeBitmap(root), ch);
+        }
+    }
+
+    for (int w = 0; w < threads; ++w) {
+        TrieArena *from = job.arenas[w];
+        if (!from) continue;
+        ArenaFreeEdgeBlock(from, EdgeClass((int)from->root.count), from->root.ptrs);
+        ArenaAdopt(a, from);
+    }
+    free(job.arenas);
+    free(job.order);
+    return root;
+}
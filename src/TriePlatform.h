@@ -0,0 +1,181 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+/* ================================================================ *
+ * Compiler / CPU portability helpers (library-private)             *
+ *                                                                  *
+ * The project builds with GCC/Clang and MSVC (/W4 /WX), so every   *
+ * intrinsic used by the engine goes through these wrappers.        *
+ * ================================================================ */
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TRIE_HAVE_SSE2 1
+#else
+#define TRIE_HAVE_SSE2 0
+#endif
+
+/* AVX2 code paths are compiled on x86-64 (GCC/Clang through a function
+ * target attribute, MSVC without flags) and only run if TrieCpuHasAvx2(). */
+#if (defined(__GNUC__) && defined(__x86_64__)) || defined(_M_X64)
+#include <immintrin.h>
+#define TRIE_CAN_AVX2 1
+#else
+#define TRIE_CAN_AVX2 0
+#endif
+
+#if defined(__GNUC__)
+#define TRIE_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TRIE_TARGET_AVX2
+#endif
+
+/* Does the CPU (and the OS, for the YMM state) support AVX2? */
+static inline int TrieCpuHasAvx2(void) {
+#if TRIE_CAN_AVX2 && defined(_MSC_VER)
+    int r[4];
+    __cpuid(r, 0);
+    if (r[0] < 7) return 0;
+    __cpuid(r, 1);
+    if (!(r[2] & (1 << 27)) || !(r[2] & (1 << 28))) return 0;   /* OSXSAVE, AVX */
+    if ((_xgetbv(0) & 6) != 6) return 0;                         /* XMM + YMM enabled */
+    __cpuidex(r, 7, 0);
+    return (r[1] >> 5) & 1;
+#elif TRIE_CAN_AVX2
+    return __builtin_cpu_supports("avx2");
+#else
+    return 0;
+#endif
+}
+
+/* Index of the lowest set bit; `x` must be non-zero. */
+static inline int TrieCtz32(uint32_t x) {
+#if defined(_MSC_VER)
+    unsigned long idx;
+    _BitScanForward(&idx, x);
+    return (int)idx;
+#elif defined(__GNUC__)
+    return __builtin_ctz(x);
+#else
+    int n = 0;
+    while (!(x & 1u)) { x >>= 1; ++n; }
+    return n;
+#endif
+}
+
+/* Index of the lowest set bit of a 64-bit word; `x` must be non-zero. */
+static inline int TrieCtz64(uint64_t x) {
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long idx;
+    _BitScanForward64(&idx, x);
+    return (int)idx;
+#elif defined(__GNUC__)
+    return __builtin_ctzll(x);
+#else
+    uint32_t lo = (uint32_t)x;
+    return lo ? TrieCtz32(lo) : 32 + TrieCtz32((uint32_t)(x >> 32));
+#endif
+}
+
+/* Population count of a 64-bit word (portable SWAR fallback). */
+static inline int TriePopcount64(uint64_t x) {
+#if defined(__GNUC__)
+    return __builtin_popcountll(x);
+#else
+    x = x - ((x >> 1) & 0x5555555555555555ull);
+    x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+    x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0full;
+    return (int)((x * 0x0101010101010101ull) >> 56);
+#endif
+}
+
+/* Hint the CPU to start loading the cache line holding `addr`. */
+static inline void TriePrefetch(const void *addr) {
+#if defined(__GNUC__)
+    __builtin_prefetch(addr);
+#elif TRIE_HAVE_SSE2
+    _mm_prefetch((const char*)addr, _MM_HINT_T0);
+#else
+    (void)addr;
+#endif
+}
+
+/* Thread-local storage class (C99 has no _Thread_local). */
+#if defined(_MSC_VER)
+#define TRIE_THREAD_LOCAL __declspec(thread)
+#else
+#define TRIE_THREAD_LOCAL __thread
+#endif
+
+/* Atomic fetch-and-add (relaxed ordering is enough for work counters;
+ * thread join provides the happens-before for the results). */
+static inline long TrieAtomicFetchAdd(volatile long *p, long v) {
+#if defined(_MSC_VER)
+    return _InterlockedExchangeAdd(p, v);
+#else
+    return __atomic_fetch_add(p, v, __ATOMIC_RELAXED);
+#endif
+}
+
+/* Publication for the live (RCU) trie. The pointer store is a release:
+ * every write that built the pointee is visible before the pointer. The
+ * loads and the long store are sequentially consistent, which the
+ * reader/grace-period handshake needs. MSVC uses full-barrier interlocked
+ * operations, which also hold on ARM. */
+static inline void *TrieAtomicLoadPtr(void *const volatile *p) {
+#if defined(_MSC_VER)
+    return _InterlockedCompareExchangePointer((void *volatile *)p, NULL, NULL);
+#else
+    return __atomic_load_n(p, __ATOMIC_SEQ_CST);
+#endif
+}
+
+static inline void TrieAtomicStorePtr(void *volatile *p, void *v) {
+#if defined(_MSC_VER)
+    _InterlockedExchangePointer(p, v);
+#else
+    __atomic_store_n(p, v, __ATOMIC_RELEASE);
+#endif
+}
+
+static inline long TrieAtomicLoad(volatile long *p) {
+#if defined(_MSC_VER)
+    return _InterlockedCompareExchange(p, 0, 0);
+#else
+    return __atomic_load_n(p, __ATOMIC_SEQ_CST);
+#endif
+}
+
+static inline void TrieAtomicStore(volatile long *p, long v) {
+#if defined(_MSC_VER)
+    _InterlockedExchange(p, v);
+#else
+    __atomic_store_n(p, v, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/* ---------------- threads (TrieThreads.c) ---------------- */
+
+/* Number of online CPUs (>= 1). */
+int  TrieCpuCount(void);
+
+/* Run fn(ctx, i) for i = 0..n-1 concurrently: i == 0 on the calling
+ * thread, the rest on new threads; returns when all have finished. If a
+ * thread cannot be started its share runs on the caller instead. */
+void TrieRunThreads(int n, void (*fn)(void *ctx, int idx), void *ctx);
+
+/* Give up the rest of the time slice (sched_yield / SwitchToThread). */
+void TrieYield(void);
+
+/* Opaque mutex (pthread_mutex_t / SRWLOCK). */
+typedef struct TrieMutex TrieMutex;
+
+TrieMutex *TrieMutexCreate(void);
+void       TrieMutexDestroy(TrieMutex *m);
+void       TrieMutexLock(TrieMutex *m);
+void       TrieMutexUnlock(TrieMutex *m);
@@ -0,0 +1,202 @@
+#include "TrieNode.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* ================================================================ *
+ * Word removal                                                     *
+ *                                                                  *
+ * TrieInsert keeps the trie canonical: below the root, a subtree   *
+ * holding exactly one word is a leaf. TrieRemove restores that     *
+ * form after taking a word out, undoing the splits of TrieInsert:  *
+ *                                                                  *
+ * 1) unmark EndOfWord, or drop the edge to the word's leaf;        *
+ * 2) non-leaves left with no word at all are dropped as well,      *
+ *    walking up (their parents lose an edge in turn);              *
+ * 3) if the lowest changed node now holds a single word (cases A/B *
+ *    reversed: EndOfWord and no edges; case C reversed: one edge   *
+ *    to a leaf), it and every single-edge ancestor above it merge  *
+ *    into one leaf whose suffix is the path letters + the tail.    *
+ *                                                                  *
+ * Edge blocks shrink with their edge count (a block always has the *
+ * class EdgeClass(count), which AddCell relies on), and released   *
+ * records and blocks go back to the arena free lists. Suffix bytes *
+ * are shared by splits and cannot be freed one by one; once dead   *
+ * ones outgrow the live ones the suffix slab is compacted instead, *
+ * so inserts + removals keep a flat footprint.                     *
+ * ================================================================ */
+
+#define SUFFIX_SLACK (64u * 1024u)   /* dead suffix bytes tolerated regardless of size */
+
+/* Remove edge `pos` from p; the block moves to the class of the new count. */
+static void RemoveCell(TrieArena *a, NonLeafPtr p, int pos) {
+    int len = (int)p->count, n = len - 1;
+    int oldCls = EdgeClass(len), cls = EdgeClass(n);
+
+    if (n == 0) {
+        ArenaFreeEdgeBlock(a, oldCls, p->ptrs);
+        p->letters = NULL;
+        p->ptrs = NULL;
+    } else if (cls != oldCls) {
+        /* the count dropped to a power of two: move to the smaller class */
+        char *letters;
+        NonLeafPtr *ptrs = ArenaEdgeBlock(a, cls, &letters);
+        memcpy(ptrs, p->ptrs, (size_t)pos * sizeof(NonLeafPtr));
+        memcpy(ptrs + pos, p->ptrs + pos + 1, (size_t)(n - pos) * sizeof(NonLeafPtr));
+        memcpy(letters, p->letters, (size_t)pos);
+        memcpy(letters + pos, p->letters + pos + 1, (size_t)(n - pos));
+        ArenaFreeEdgeBlock(a, oldCls, p->ptrs);
+        p->letters = letters;
+        p->ptrs = ptrs;
+        if (cls >= TRIE_WIDE_CLASS)
+            for (int i = 0; i < n; ++i) BitmapSet(EdgeBitmap(p), letters[i]);
+    } else {
+        if (cls >= TRIE_WIDE_CLASS) BitmapClear(EdgeBitmap(p), p->letters[pos]);
+        memmove(p->ptrs + pos, p->ptrs + pos + 1, (size_t)(n - pos) * sizeof(NonLeafPtr));
+        memmove(p->letters + pos, p->letters + pos + 1, (size_t)(n - pos));
+    }
+    p->count = (unsigned)n;
+}
+
+/* Does the subtree of p hold exactly one word? */
+static int SingleWord(NonLeafPtr p) {
+    if (p->EndOfWord == yes) return p->count == 0;
+    return p->count == 1 && p->ptrs[0]->kind == leaf;
+}
+
+static unsigned int SubtreeMax(NonLeafPtr p) {
+    unsigned int m = p->EndOfWord == yes ? p->weight : 0;
+    for (int i = 0; i < (int)p->count; ++i) {
+        NonLeafPtr c = p->ptrs[i];
+        unsigned int w = c->kind == leaf ? ((LeafPtr)c)->weight : c->maxWeight;
+        if (w > m) m = w;
+    }
+    return m;
+}
+
+/* ========================= *
+ * Suffix compaction         *
+ * ========================= */
+
+static size_t LiveSuffixBytes(NonLeafPtr p) {
+    if (p->kind == leaf) return strlen(((LeafPtr)p)->word) + 1;
+    size_t n = 0;
+    for (int i = 0; i < (int)p->count; ++i) n += LiveSuffixBytes(p->ptrs[i]);
+    return n;
+}
+
+static void RecopySuffixes(TrieArena *a, NonLeafPtr p) {
+    if (p->kind == leaf) {
+        LeafPtr lf = (LeafPtr)p;
+        lf->word = ArenaSuffix(a, lf->word, strlen(lf->word));
+        return;
+    }
+    for (int i = 0; i < (int)p->count; ++i) RecopySuffixes(a, p->ptrs[i]);
+}
+
+/* Compact once at least half of the suffix slab is dead. The check walks
+ * the trie, so it only runs after the slab grew by its last live size. */
+static void MaybeCompactSuffixes(TrieArena *a) {
+    if (a->suffixBytes <= 2 * a->suffixLive + SUFFIX_SLACK) return;
+
+    size_t live = LiveSuffixBytes(&a->root);
+    if (2 * live < a->suffixBytes) {
+        ArenaSlab old = ArenaSuffixesDetach(a);
+        RecopySuffixes(a, &a->root);
+        ArenaSlabRelease(&old);
+    }
+    a->suffixLive = live;
+}
+
+/* ========================= *
+ * Remove                    *
+ * ========================= */
+
+int TrieRemove(NonLeafPtr root, const char *word) {
+    size_t len = strlen(word);
+    NonLeafPtr *path = (NonLeafPtr*)malloc((len + 1) * sizeof(NonLeafPtr));
+    int *slot = (int*)malloc((len + 1) * sizeof(int));    /* edge taken out of path[i] */
+    if (!path || !slot) Error("out of memory: TrieRemove");
+
+    /* find the word: it ends at path[d] (EndOfWord) or in leaf `lf` below it */
+    NonLeafPtr p = root;
+    LeafPtr lf = NULL;
+    size_t d = 0;
+    int found = 0;
+    while (1) {
+        path[d] = p;
+        if (word[d] == '\0') {
+            found = p->EndOfWord == yes;
+            break;
+        }
+        int pos = Position(p, word[d]);
+        if (pos == notFound || !p->ptrs[pos]) break;
+        slot[d] = pos;
+        NonLeafPtr child = p->ptrs[pos];
+        if (child->kind == leaf) {
+            lf = (LeafPtr)child;
+            found = strcmp(lf->word, word + d + 1) == 0;
+            break;
+        }
+        p = child;
+        ++d;
+    }
+    if (!found) {
+        free(path);
+        free(slot);
+        return notFound;
+    }
+
+    TrieArena *a = ArenaOf(root);
+    NonLeafPtr q = path[d];
+
+    /* 1) take the word out */
+    if (lf) {
+        RemoveCell(a, q, slot[d]);
+        ArenaFreeLeaf(a, lf);
+    } else {
+        q->EndOfWord = !yes;
+        q->weight = 0;
+    }
+
+    /* 2) drop non-leaves that no longer hold any word */
+    while (d > 0 && q->count == 0 && q->EndOfWord != yes) {
+        ArenaFreeNonLeaf(a, q);
+        q = path[--d];
+        RemoveCell(a, q, slot[d]);
+    }
+
+    /* 3) merge a single-word subtree (and its single-edge ancestors) into a leaf */
+    if (d > 0 && SingleWord(q)) {
+        size_t top = d;
+        while (top > 1 && path[top - 1]->EndOfWord != yes && path[top - 1]->count == 1) --top;
+
+        int hasEdge = q->count == 1;
+        LeafPtr only = hasEdge ? (LeafPtr)q->ptrs[0] : NULL;
+        const char *tail = hasEdge ? only->word : "";
+        size_t k = d - top, tl = strlen(tail);
+
+        LeafPtr merged = ArenaNewLeaf(a);
+        merged->kind = leaf;
+        merged->weight = hasEdge ? only->weight : q->weight;
+        merged->word = ArenaSuffixAlloc(a, k + (size_t)hasEdge + tl);
+        memcpy(merged->word, word + top, k);             /* letters from path[top] down to q */
+        if (hasEdge) merged->word[k] = q->letters[0];
+        memcpy(merged->word + k + hasEdge, tail, tl);
+
+        if (hasEdge) ArenaFreeLeaf(a, only);
+        for (size_t i = top; i <= d; ++i) {
+            if (path[i]->count > 0) ArenaFreeEdgeBlock(a, EdgeClass((int)path[i]->count), path[i]->ptrs);
+            ArenaFreeNonLeaf(a, path[i]);
+        }
+        d = top - 1;
+        path[d]->ptrs[slot[d]] = (NonLeafPtr)merged;
+    }
+
+    /* cached maxima on the surviving path */
+    for (size_t i = d + 1; i-- > 0; ) path[i]->maxWeight = SubtreeMax(path[i]);
+
+    free(path);
+    free(slot);
+    MaybeCompactSuffixes(a);
+    return success;
+}
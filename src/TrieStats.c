@@ -0,0 +1,80 @@
+#include "TrieNode.h"
+#include <string.h>
+
+/* ================================================================ *
+ * Trie statistics and hot-path counters                            *
+ *                                                                  *
+ * TrieGetStats walks the pointer trie once (recursion depth is the *
+ * longest word) and reads the heap figures straight from the arena *
+ * chunk lists, so they are exact rather than estimated.            *
+ *                                                                  *
+ * The counters are thread-local, so concurrent readers never share *
+ * a cache line; each thread sees only its own calls.               *
+ * ================================================================ */
+
+#if defined(TRIE_COUNTERS) && TRIE_COUNTERS
+TRIE_THREAD_LOCAL TrieCounters trieCounters;
+#endif
+
+static size_t SlabHeapBytes(const ArenaSlab *s) {
+    size_t n = 0;
+    for (const ArenaChunk *c = s->chunks; c; c = c->next)
+        n += sizeof(ArenaChunk) + c->size;
+    return n;
+}
+
+static void CountWord(TrieStats *st, size_t depth) {
+    ++st->words;
+    ++st->wordDepth[depth < TRIE_STATS_DEPTHS ? depth : TRIE_STATS_DEPTHS - 1];
+}
+
+static void Walk(TrieStats *st, NonLeafPtr p, size_t depth) {
+    if (depth > st->maxDepth) st->maxDepth = depth;
+
+    if (p->kind == leaf) {
+        ++st->leaves;
+        st->suffixBytes += strlen(((LeafPtr)p)->word) + 1;
+        CountWord(st, depth);
+        return;
+    }
+
+    ++st->nonLeaves;
+    ++st->fanout[p->count];
+    if (p->EndOfWord == yes) CountWord(st, depth);
+
+    for (int i = 0; i < (int)p->count; ++i) {
+        if (!p->ptrs[i]) continue;
+        ++st->edges;
+        Walk(st, p->ptrs[i], depth + 1);
+    }
+}
+
+void TrieGetStats(NonLeafPtr root, TrieStats *out) {
+    memset(out, 0, sizeof(*out));
+    if (!root) return;
+
+    Walk(out, root, 0);
+
+    const TrieArena *a = ArenaOf(root);
+    out->nodeHeapBytes = SlabHeapBytes(&a->nodes);
+    out->edgeHeapBytes = SlabHeapBytes(&a->edges);
+    out->suffixHeapBytes = SlabHeapBytes(&a->suffixes);
+    out->heapBytes = sizeof(TrieArena) + out->nodeHeapBytes
+                   + out->edgeHeapBytes + out->suffixHeapBytes;
+}
+
+int TrieCountersGet(TrieCounters *out) {
+#if defined(TRIE_COUNTERS) && TRIE_COUNTERS
+    *out = trieCounters;
+    return 1;
+#else
+    memset(out, 0, sizeof(*out));
+    return 0;
+#endif
+}
+
+void TrieCountersReset(void) {
+#if defined(TRIE_COUNTERS) && TRIE_COUNTERS
+    memset(&trieCounters, 0, sizeof(trieCounters));
+#endif
+}
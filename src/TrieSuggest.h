@@ -0,0 +1,78 @@
+#pragma once
+#include "SimpleTrieSpellChecker.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* ================================================================ *
+ * Suggestion helpers shared by the suggestion engines              *
+ * (pointer trie, frozen trie, cache); library-private.             *
+ * ================================================================ */
+
+/* Path buffer of a one-edit DFS for `word`. With a single edit the walk
+ * is never more than one char deeper than the input it consumed, so
+ * strlen(word) + 3 bytes always suffice, however long the dictionary
+ * words are: `small` (of `smallSize` bytes) serves short words, longer
+ * ones get a heap buffer, which SuggestPrefixFree releases. */
+static inline char *SuggestPrefixBuffer(char *small, size_t smallSize, const char *word) {
+    size_t need = strlen(word) + 3;
+    char *prefix = need <= smallSize ? small : (char*)malloc(need);
+    if (!prefix) Error("out of memory: suggestions");
+    prefix[0] = '\0';
+    return prefix;
+}
+
+static inline void SuggestPrefixFree(char *prefix, const char *small) {
+    if (prefix != small) free(prefix);
+}
+
+/* Reset `box` to hold up to `maxSuggestions` items; 0 if out of memory. */
+int  SuggestBoxInit(SuggestBox *box, int maxSuggestions);
+
+/* Append a copy of `w` unless it is already present or the box is full. */
+void SuggestBoxAdd(SuggestBox *box, const char *w);
+
+/* SuggestResult (SuggestResult.c): start a search holding up to
+ * `maxSuggestions` words; append prefix + tail unless it is a duplicate
+ * or the result is full; copy the words into an initialized box. */
+void ResultReset(SuggestResult *r, int maxSuggestions);
+void ResultAddWord(SuggestResult *r, const char *prefix, const char *tail);
+void ResultToBox(const SuggestResult *r, SuggestBox *box);
+
+/* Work limit of one suggestion search (SuggestOptions.c). */
+typedef struct {
+    size_t nodes;                 /* nodes entered so far */
+    size_t maxNodes;              /* 0 = no limit */
+    unsigned long long deadlineNs;/* 0 = no deadline */
+} SuggestBudget;
+
+#define BUDGET_CLOCK_EVERY 32     /* nodes between deadline checks */
+
+/* Charge one node; 0 once the node limit or the deadline is passed. */
+static inline int BudgetCharge(SuggestBudget *b) {
+    ++b->nodes;
+    if (b->maxNodes && b->nodes > b->maxNodes) return 0;
+    if (b->deadlineNs && b->nodes % BUDGET_CLOCK_EVERY == 0 && TrieNowNs() >= b->deadlineNs)
+        return 0;
+    return 1;
+}
+
+/* Can no dictionary word be within one edit of `word`, judging by the
+ * length range and alphabet in `opts`? */
+int  SuggestPrefilterRejects(const SuggestOptions *opts, const char *word);
+
+/* Tail matcher for <=1 edit between tailA (dict leaf suffix) and tailB
+ * (input suffix), given the edits already spent on the way down. */
+int  TailWithinOneEdit(const char *tailA, const char *tailB, int edits_used);
+
+/* Kinds of the single edit a one-edit candidate was reached with. */
+enum {
+    editNone = 0,                 /* exact match */
+    editSubstitution,
+    editInsertion,                /* extra char in the input */
+    editDeletion,                 /* char missing from the input */
+    editTransposition
+};
+
+/* Same test as TailWithinOneEdit, reporting which edit matched the tails
+ * (editNone if equal), or notFound if they need more edits. */
+int  TailEditKind(const char *tailA, const char *tailB, int edits_used);
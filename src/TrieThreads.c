@@ -0,0 +1,157 @@
+#include "SimpleTrieSpellChecker.h"
+#include "TriePlatform.h"
+#include <stdlib.h>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+/* ================================================================ *
+ * Minimal portable threading: fork/join helper and a mutex         *
+ * (Win32 threads / SRW locks or pthreads).                         *
+ * ================================================================ */
+
+typedef struct {
+    void (*fn)(void *ctx, int idx);
+    void *ctx;
+    int idx;
+} ThreadTask;
+
+#if defined(_WIN32)
+
+static DWORD WINAPI ThreadMain(LPVOID arg) {
+    ThreadTask *t = (ThreadTask*)arg;
+    t->fn(t->ctx, t->idx);
+    return 0;
+}
+
+int TrieCpuCount(void) {
+    SYSTEM_INFO si;
+    GetSystemInfo(&si);
+    return si.dwNumberOfProcessors > 0 ? (int)si.dwNumberOfProcessors : 1;
+}
+
+#else
+
+static void *ThreadMain(void *arg) {
+    ThreadTask *t = (ThreadTask*)arg;
+    t->fn(t->ctx, t->idx);
+    return NULL;
+}
+
+int TrieCpuCount(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+}
+
+#endif
+
+/* ========================= *
+ * Mutex                     *
+ * ========================= */
+
+struct TrieMutex {
+#if defined(_WIN32)
+    SRWLOCK lock;
+#else
+    pthread_mutex_t lock;
+#endif
+};
+
+TrieMutex *TrieMutexCreate(void) {
+    TrieMutex *m = (TrieMutex*)malloc(sizeof(*m));
+    if (!m) Error("out of memory: TrieMutexCreate");
+#if defined(_WIN32)
+    InitializeSRWLock(&m->lock);
+#else
+    if (pthread_mutex_init(&m->lock, NULL) != 0) Error("TrieMutexCreate: pthread_mutex_init");
+#endif
+    return m;
+}
+
+void TrieMutexDestroy(TrieMutex *m) {
+    if (!m) return;
+#if !defined(_WIN32)
+    pthread_mutex_destroy(&m->lock);
+#endif
+    free(m);
+}
+
+void TrieYield(void) {
+#if defined(_WIN32)
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+}
+
+void TrieMutexLock(TrieMutex *m) {
+#if defined(_WIN32)
+    AcquireSRWLockExclusive(&m->lock);
+#else
+    pthread_mutex_lock(&m->lock);
+#endif
+}
+
+void TrieMutexUnlock(TrieMutex *m) {
+#if defined(_WIN32)
+    ReleaseSRWLockExclusive(&m->lock);
+#else
+    pthread_mutex_unlock(&m->lock);
+#endif
+}
+
+/* ========================= *
+ * Fork / join               *
+ * ========================= */
+
+void TrieRunThreads(int n, void (*fn)(void *ctx, int idx), void *ctx) {
+    if (n <= 1) {
+        fn(ctx, 0);
+        return;
+    }
+
+    ThreadTask *tasks = (ThreadTask*)calloc((size_t)n, sizeof(ThreadTask));
+    char *started = (char*)calloc((size_t)n, 1);
+#if defined(_WIN32)
+    HANDLE *threads = (HANDLE*)calloc((size_t)n, sizeof(HANDLE));
+#else
+    pthread_t *threads = (pthread_t*)calloc((size_t)n, sizeof(pthread_t));
+#endif
+    if (!tasks || !started || !threads) Error("out of memory: TrieRunThreads");
+
+    for (int i = 1; i < n; ++i) {
+        tasks[i].fn = fn;
+        tasks[i].ctx = ctx;
+        tasks[i].idx = i;
+#if defined(_WIN32)
+        threads[i] = CreateThread(NULL, 0, ThreadMain, &tasks[i], 0, NULL);
+        started[i] = threads[i] != NULL;
+#else
+        started[i] = pthread_create(&threads[i], NULL, ThreadMain, &tasks[i]) == 0;
+#endif
+    }
+
+    fn(ctx, 0);
+    for (int i = 1; i < n; ++i) {
+        if (!started[i]) {
+            fn(ctx, i);
+            continue;
+        }
+#if defined(_WIN32)
+        WaitForSingleObject(threads[i], INFINITE);
+        CloseHandle(threads[i]);
+#else
+        pthread_join(threads[i], NULL);
+#endif
+    }
+
+    free(threads);
+    free(started);
+    free(tasks);
+}
@@ -0,0 +1,101 @@
+#include "TrieNode.h"
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ================================================================ *
+ * Word weights (frequencies)                                       *
+ *                                                                  *
+ * Every word carries a weight: in its leaf, or in the non-leaf     *
+ * where it ends (EndOfWord). Each non-leaf also caches maxWeight,  *
+ * the largest weight in its subtree, which lets ranked searches    *
+ * skip subtrees that cannot produce a better candidate.            *
+ *                                                                  *
+ * Weights only ever grow, so an insert just raises maxWeight along *
+ * the word's path; leaf splits in TrieInsert carry the old leaf's  *
+ * weight into the nodes they create.                               *
+ * ================================================================ */
+
+#define WEIGHTED_MAX_WORD 255     /* longer entries are skipped, like main.c's %255s */
+
+/* Weight field of `word`'s terminal node, or NULL if not a word. */
+static unsigned int *WeightSlot(NonLeafPtr root, const char *word) {
+    NonLeafPtr p = root;
+    int pos;
+
+    while (1) {
+        if (p->kind == leaf) {
+            LeafPtr lf = (LeafPtr)p;
+            return strcmp(word, lf->word) == 0 ? &lf->weight : NULL;
+        } else if (*word == '\0') {
+            return p->EndOfWord == yes ? &p->weight : NULL;
+        } else if ((pos = Position(p, *word)) != notFound && p->ptrs[pos]) {
+            p = p->ptrs[pos];
+            ++word;
+        } else {
+            return NULL;
+        }
+    }
+}
+
+void TrieInsertWeighted(char *word, unsigned int weight, NonLeafPtr root) {
+    TrieInsert(word, root);
+
+    unsigned int *slot = WeightSlot(root, word);
+    unsigned int w = *slot + weight;
+    if (w < *slot) w = UINT_MAX;                   /* saturate */
+    *slot = w;
+
+    /* raise the cached maxima on the path (the leaf has none) */
+    NonLeafPtr p = root;
+    while (1) {
+        if (p->maxWeight < w) p->maxWeight = w;
+        if (*word == '\0') return;
+        NonLeafPtr child = p->ptrs[Position(p, *word)];
+        if (child->kind == leaf) return;
+        p = child;
+        ++word;
+    }
+}
+
+unsigned int TrieWordWeight(NonLeafPtr root, const char *word) {
+    unsigned int *slot = WeightSlot(root, word);
+    return slot ? *slot : 0;
+}
+
+NonLeafPtr TrieLoadWeighted(const char *path) {
+    FILE *f = fopen(path, "r");
+    if (!f) return NULL;
+
+    NonLeafPtr root = NULL;
+    char line[512];
+
+    while (fgets(line, sizeof(line), f)) {
+        size_t n = strlen(line);
+        if (n == sizeof(line) - 1 && line[n - 1] != '\n') {
+            /* over-long line: skip the rest of it and the entry */
+            int ch;
+            while ((ch = fgetc(f)) != EOF && ch != '\n');
+            continue;
+        }
+
+        char *word = line;
+        while (*word == ' ' || *word == '\t') ++word;
+        char *end = word;
+        while (*end && *end != '\t' && *end != ' ' && *end != '\n' && *end != '\r') ++end;
+        if (end == word) continue;                  /* blank line */
+        if (end - word > WEIGHTED_MAX_WORD) continue;
+
+        unsigned long long count = 0;
+        if (*end == '\t' || *end == ' ') count = strtoull(end + 1, NULL, 10);
+        *end = '\0';
+        strupr_local(word);
+
+        if (!root) root = TrieCreateWithFirstWord(word);
+        TrieInsertWeighted(word, count > UINT_MAX ? UINT_MAX : (unsigned int)count, root);
+    }
+
+    fclose(f);
+    return root;
+}
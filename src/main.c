@@ -1,21 +1,31 @@
 #include "SimpleTrieSpellChecker.h"
 #include <stdio.h>
 #include <stdlib.h>
-#include <ctype.h>
 #include <string.h>
 
 /* Demo program:
  * - builds a trie from "dictionary" (one word per token),
  * - prints a side-view,
- * - scans "text" and reports misspelled words with suggestions.
+ * - scans "text" (SpellCheckBufferParallel, one worker per CPU) and
+ *   reports misspelled words with suggestions (repeated typos are
+ *   answered from a SuggestCache).
+ *
+ * `SimpleTrieSpellChecker --index` takes the suggestions from a deletion
+ * index (SuggestCorrectionsIndexed, nearest first) instead of the trie.
  *
  * Files are read as ASCII; input tokens are uppercased. */
 
-int main(void) {
+int main(int argc, char **argv) {
     FILE *FIn = NULL, *words = NULL;
     char word[256], prefix[256] = "";
     NonLeafPtr root;
-    int i, lineNum = 1, ch;
+    SuggestCache *cache = NULL;
+    DeleteIndex *index = NULL;
+    int useIndex = argc > 1 && strcmp(argv[1], "--index") == 0;
+    MisspellingList bad = { NULL, 0, 0 };
+    char *text = NULL;
+    long textLen;
+    int i;
 
     /* Build dictionary */
     words = fopen("dictionary", "r");
@@ -31,49 +41,55 @@ int main(void) {
     puts("SIDE VIEW");
     TrieSideView(0, root, prefix);
 
-    /* Spell-check */
+    /* Spell-check: load the whole text, let the library scan it */
     FIn = fopen("text", "rb");
     if (!FIn) Error("can't open `text`");
+    if (fseek(FIn, 0, SEEK_END) != 0) Error("can't size `text`");
+    textLen = ftell(FIn);
+    if (textLen < 0) Error("can't size `text`");
+    rewind(FIn);
+    text = (char*)malloc((size_t)textLen + 1);
+    if (!text || fread(text, 1, (size_t)textLen, FIn) != (size_t)textLen) Error("can't read `text`");
 
     puts("Misspelled words (with suggestions):");
-    ch = fgetc(FIn);
-    while (1) {
-        /* skip non-letters and track lines */
-        while (ch != EOF && !isalpha((unsigned char)ch)) {
-            if ((char)ch == '\n') lineNum++;
-            ch = fgetc(FIn);
-        }
-        if (ch == EOF) break;
+    if (useIndex) {
+        index = DeleteIndexBuild(root, 1, 7);
+        printf("(suggestions from a deletion index, %zu bytes)\n", DeleteIndexBytes(index));
+    } else {
+        cache = SuggestCacheCreate(root, 1u << 20);   /* repeated typos */
+    }
+    SpellCheckBufferParallel(root, text, (size_t)textLen, 0, useIndex ? 0 : 10,
+                             useIndex ? NULL : cache, &bad);
 
-        /* read a word token */
-        i = 0;
-        while (ch != EOF && isalpha((unsigned char)ch)) {
-            if (i < (int)sizeof(word) - 1) word[i++] = (char)ch;
-            ch = fgetc(FIn);
-        }
+    for (size_t m = 0; m < bad.count; ++m) {
+        const Misspelling *ms = &bad.items[m];
+        SuggestBox *box = &bad.items[m].suggestions;
+
+        /* copy the token for printing */
+        i = ms->length < sizeof(word) - 1 ? (int)ms->length : (int)sizeof(word) - 1;
+        memcpy(word, text + ms->offset, (size_t)i);
         word[i] = '\0';
         strupr_local(word);
+        if (index) SuggestCorrectionsIndexed(index, word, 1, 10, box);
 
-        /* exact lookup; if missing, print suggestions */
-        if (SearchTrie(root, word) != success) {
-            printf("%s on line %d\n", word, lineNum);
-
-            SuggestBox box;
-            SuggestCorrections(root, word, 10, &box);
-            if (box.count > 0) {
-                printf("  Did you mean:");
-                for (int k = 0; k < box.count; ++k) {
-                    printf(" %s%s", box.items[k], (k + 1 < box.count ? "," : ""));
-                }
-                printf("\n");
-            } else {
-                printf("  (no close suggestions)\n");
+        printf("%s on line %zu\n", word, ms->line);
+        if (box->count > 0) {
+            printf("  Did you mean:");
+            for (int k = 0; k < box->count; ++k) {
+                printf(" %s%s", box->items[k], (k + 1 < box->count ? "," : ""));
             }
-            FreeSuggestBox(&box);
+            printf("\n");
+        } else {
+            printf("  (no close suggestions)\n");
         }
     }
 
+    FreeMisspellingList(&bad);
+    SuggestCacheDestroy(cache);
+    DeleteIndexDestroy(index);
+    free(text);
     fclose(words);
     fclose(FIn);
+    TrieDestroy(root);
     return 0;
 }
@@ -0,0 +1,81 @@
+#include "tests.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* SuggestCorrectionsIndexed must return what SuggestCorrectionsK returns
+ * (same words, same order) for k <= maxDistance, whatever the prefix
+ * length: the index only narrows the candidates, so a prefix shorter than
+ * the word may neither add nor lose a suggestion. Queries are dictionary
+ * words with up to two edits anywhere (inside and past the prefix) and a
+ * few random strings; a small alphabet gives every query many neighbours.
+ * Edits may leave a query empty (all words of up to k letters match). */
+
+#define DICT_WORDS   3000
+#define QUERIES      1500
+#define MAX_DISTANCE 2
+
+static const int PREFIX_LENGTHS[] = { 0, 1, 2, 3, 5, 7 };
+static const int MAX_SUGGESTIONS[] = { 3, 1000 };
+
+int TestDeleteIndex(void) {
+    TestRng r = { 0x5eed0013ull };
+    char (*q)[24] = (char(*)[24])malloc(QUERIES * sizeof(*q));
+    char w[24];
+    if (!q) Error("out of memory: test");
+
+    TestWord(&r, w, 1, 14, 8);
+    NonLeafPtr root = TrieCreateWithFirstWord(w);
+    for (int i = 1; i < DICT_WORDS; ++i) {
+        TestWord(&r, w, 1, 14, 8);
+        TrieInsert(w, root);
+    }
+
+    /* edit words taken back from the trie (SuggestCorrectionsK, k = 0) */
+    for (int i = 0; i < QUERIES; ++i) {
+        if (TestNext(&r, 10) == 0) {
+            TestWord(&r, q[i], 1, 16, 8);
+            continue;
+        }
+        TestWord(&r, w, 1, 14, 8);
+        SuggestBox near = { NULL, 0, 0 };
+        SuggestCorrectionsK(root, w, MAX_DISTANCE, 1, &near);
+        strcpy(q[i], near.count ? near.items[0] : w);
+        FreeSuggestBox(&near);
+        for (unsigned e = TestNext(&r, MAX_DISTANCE + 1); e > 0; --e) TestEdit(&r, q[i], 8);
+    }
+    q[0][0] = '\0';                                      /* and certainly the empty word */
+
+    int failures = 0, hits = 0;
+
+    /* "" is one edit from every one-letter word: the one-edit DFS agrees */
+    SuggestBox one = { NULL, 0, 0 }, k1 = { NULL, 0, 0 };
+    SuggestCorrections(root, "", 1000, &one);
+    SuggestCorrectionsK(root, "", 1, 1000, &k1);
+    EXPECT(failures, one.count > 0 && TestSameBox(&one, &k1),
+           "SuggestCorrectionsK(\"\", 1) gives %d words, SuggestCorrections %d",
+           k1.count, one.count);
+    FreeSuggestBox(&one);
+    FreeSuggestBox(&k1);
+    for (size_t p = 0; p < sizeof(PREFIX_LENGTHS) / sizeof(PREFIX_LENGTHS[0]); ++p) {
+        DeleteIndex *ix = DeleteIndexBuild(root, MAX_DISTANCE, PREFIX_LENGTHS[p]);
+        for (int k = 1; k <= MAX_DISTANCE; ++k)
+            for (size_t m = 0; m < sizeof(MAX_SUGGESTIONS) / sizeof(MAX_SUGGESTIONS[0]); ++m)
+                for (int i = 0; i < QUERIES && failures < 10; ++i) {
+                    SuggestBox want = { NULL, 0, 0 }, got = { NULL, 0, 0 };
+                    SuggestCorrectionsK(root, q[i], k, MAX_SUGGESTIONS[m], &want);
+                    SuggestCorrectionsIndexed(ix, q[i], k, MAX_SUGGESTIONS[m], &got);
+                    EXPECT(failures, TestSameBox(&want, &got),
+                           "prefix %d, k = %d, max %d: `%s` gives %d words, expected %d",
+                           PREFIX_LENGTHS[p], k, MAX_SUGGESTIONS[m], q[i], got.count, want.count);
+                    hits += want.count;
+                    FreeSuggestBox(&want);
+                    FreeSuggestBox(&got);
+                }
+        DeleteIndexDestroy(ix);
+    }
+    EXPECT(failures, hits > QUERIES * 10, "only %d suggestions in all", hits);
+
+    free(q);
+    TrieDestroy(root);
+    return failures;
+}
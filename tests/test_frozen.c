@@ -0,0 +1,169 @@
+#include "tests.h"
+#include "TrieFrozen.h"
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* TrieFreeze minimizes the trie into a DAWG (shared subtrees, merged
+ * suffix tails); SearchFrozen and SuggestCorrectionsFrozen must still
+ * answer exactly like SearchTrie and SuggestCorrections (same list, same
+ * order), and so must the same trie after TrieSave + TrieOpenMapped. A
+ * stem x ending dictionary gives the minimization plenty to share; a
+ * random one gives it little. TrieOpenMapped must refuse truncated or
+ * padded files and files with a damaged header field (it checks only the
+ * header and the size, see its doc). */
+
+#define QUERIES    3000
+#define MAX_WORD   32
+#define SAVE_FILE  "tests_frozen.bin"
+
+static const char *ENDINGS[] = { "", "S", "ED", "ING", "INGS", "ER", "ERS", "ATION", "ATIONS" };
+static const int MAX_SUGGESTIONS[] = { 3, 1000 };
+
+typedef struct {
+    char (*pool)[MAX_WORD + 1];
+    size_t n;
+} Dict;
+
+static int CheckFrozen(TestRng *r, NonLeafPtr root, const FrozenTrie *ft, const Dict *d,
+                       const char *what) {
+    int failures = 0;
+    for (int i = 0; i < QUERIES && failures < 10; ++i) {
+        char q[MAX_WORD + 16];
+        TestQuery(r, q, d->pool[TestNext(r, (unsigned)d->n)], 8);
+        if (!q[0]) continue;
+
+        EXPECT(failures, SearchFrozen(ft, q) == SearchTrie(root, q),
+               "%s: SearchFrozen(%s) = %d, SearchTrie %d", what, q, SearchFrozen(ft, q),
+               SearchTrie(root, q));
+        for (size_t m = 0; m < sizeof(MAX_SUGGESTIONS) / sizeof(MAX_SUGGESTIONS[0]); ++m) {
+            SuggestBox want = { NULL, 0, 0 }, got = { NULL, 0, 0 };
+            SuggestCorrections(root, q, MAX_SUGGESTIONS[m], &want);
+            SuggestCorrectionsFrozen(ft, q, MAX_SUGGESTIONS[m], &got);
+            EXPECT(failures, TestSameBox(&want, &got),
+                   "%s, max %d: `%s` gives %d words, SuggestCorrections %d",
+                   what, MAX_SUGGESTIONS[m], q, got.count, want.count);
+            FreeSuggestBox(&want);
+            FreeSuggestBox(&got);
+        }
+    }
+    return failures;
+}
+
+/* Write `bytes` of `blob` as the dictionary file; 0 on I/O failure. */
+static int WriteFile(const void *blob, size_t bytes) {
+    FILE *f = fopen(SAVE_FILE, "wb");
+    if (!f) return 0;
+    int ok = fwrite(blob, 1, bytes, f) == bytes;
+    return fclose(f) == 0 && ok;
+}
+
+/* TrieOpenMapped on a damaged copy of a valid file must give NULL. */
+static int CheckDamaged(const char *blob, size_t bytes) {
+    int failures = 0;
+    char *copy = (char*)malloc(bytes + 64);
+    if (!copy) Error("out of memory: test");
+
+    size_t cuts[6];
+    cuts[0] = 0;
+    cuts[1] = 1;
+    cuts[2] = sizeof(FrozenHeader) - 1;
+    cuts[3] = sizeof(FrozenHeader);
+    cuts[4] = bytes / 2;
+    cuts[5] = bytes - 1;
+    for (size_t c = 0; c < sizeof(cuts) / sizeof(cuts[0]); ++c) {
+        EXPECT(failures, WriteFile(blob, cuts[c]), "can't write " SAVE_FILE);
+        FrozenTrie *ft = TrieOpenMapped(SAVE_FILE);
+        EXPECT(failures, ft == NULL, "file cut to %zu of %zu bytes was accepted", cuts[c], bytes);
+        FrozenTrieDestroy(ft);
+    }
+
+    memcpy(copy, blob, bytes);
+    memset(copy + bytes, 0, 64);
+    EXPECT(failures, WriteFile(copy, bytes + 64), "can't write " SAVE_FILE);
+    FrozenTrie *padded = TrieOpenMapped(SAVE_FILE);
+    EXPECT(failures, padded == NULL, "file with 64 extra bytes was accepted");
+    FrozenTrieDestroy(padded);
+
+    static const size_t fields[] = {
+        offsetof(FrozenHeader, magic), offsetof(FrozenHeader, magic) + 7,
+        offsetof(FrozenHeader, version), offsetof(FrozenHeader, headerBytes),
+        offsetof(FrozenHeader, nodeWords), offsetof(FrozenHeader, suffixBytes),
+        offsetof(FrozenHeader, byteOrder)
+    };
+    for (size_t f = 0; f < sizeof(fields) / sizeof(fields[0]); ++f) {
+        memcpy(copy, blob, bytes);
+        copy[fields[f]] = (char)(copy[fields[f]] ^ 0x11);
+        EXPECT(failures, WriteFile(copy, bytes), "can't write " SAVE_FILE);
+        FrozenTrie *ft = TrieOpenMapped(SAVE_FILE);
+        EXPECT(failures, ft == NULL, "header byte %zu damaged, file accepted", fields[f]);
+        FrozenTrieDestroy(ft);
+    }
+
+    free(copy);
+    return failures;
+}
+
+/* `shared`: the dictionary repeats subtree shapes, so the frozen form
+ * must have well under half as many records as the trie has non-leaves. */
+static int CheckDict(TestRng *r, const Dict *d, const char *name, int shared) {
+    int failures = 0;
+    NonLeafPtr root = TrieCreateWithFirstWord(d->pool[0]);
+    for (size_t i = 1; i < d->n; ++i) TrieInsert(d->pool[i], root);
+
+    FrozenTrie *ft = TrieFreeze(root);
+    TrieStats stats;
+    TrieGetStats(root, &stats);
+    EXPECT(failures, !shared || 2 * (size_t)ft->hdr->nodeCount < stats.nonLeaves,
+           "%s: %u frozen records for %zu non-leaves, subtrees not shared",
+           name, ft->hdr->nodeCount, stats.nonLeaves);
+    failures += CheckFrozen(r, root, ft, d, name);
+
+    EXPECT(failures, TrieSave(root, SAVE_FILE) == success, "%s: TrieSave failed", name);
+    FrozenTrie *mapped = TrieOpenMapped(SAVE_FILE);
+    EXPECT(failures, mapped != NULL && FrozenTrieBytes(mapped) == FrozenTrieBytes(ft),
+           "%s: TrieOpenMapped failed on a fresh file", name);
+    if (mapped) {
+        EXPECT(failures, memcmp(mapped->hdr, ft->hdr, ft->bytes) == 0,
+               "%s: the file differs from the frozen blob", name);
+        failures += CheckFrozen(r, root, mapped, d, name);
+        FrozenTrieDestroy(mapped);
+    }
+
+    failures += CheckDamaged((const char*)ft->hdr, ft->bytes);
+    remove(SAVE_FILE);
+
+    FrozenTrieDestroy(ft);
+    TrieDestroy(root);
+    return failures;
+}
+
+int TestFrozen(void) {
+    TestRng r = { 0x5eed0005ull };
+    int failures = 0;
+    Dict d;
+    const size_t nEndings = sizeof(ENDINGS) / sizeof(ENDINGS[0]);
+
+    d.pool = (char(*)[MAX_WORD + 1])malloc(8000 * sizeof(*d.pool));
+    if (!d.pool) Error("out of memory: test");
+
+    /* stems x endings: every stem's subtree has the same shape */
+    d.n = 0;
+    for (int s = 0; s < 800; ++s) {
+        char stem[MAX_WORD + 1];
+        TestWord(&r, stem, 2, 9, 8);
+        for (size_t e = 0; e < nEndings; ++e)
+            if (e == 0 || TestNext(&r, 4) != 0) {
+                strcpy(d.pool[d.n], stem);
+                strcat(d.pool[d.n++], ENDINGS[e]);
+            }
+    }
+    failures += CheckDict(&r, &d, "stems x endings", 1);
+
+    d.n = 0;
+    while (d.n < 8000) TestWord(&r, d.pool[d.n++], 1, 12, 8);
+    failures += CheckDict(&r, &d, "random", 0);
+
+    free(d.pool);
+    return failures;
+}
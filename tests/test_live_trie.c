@@ -0,0 +1,116 @@
+#include "tests.h"
+#include "TriePlatform.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* LiveTrie under load: one writer inserts words while reader threads run
+ * SearchTrie and SuggestCorrections in read sections. The writer
+ * publishes how many of its inserts have returned; a reader reads that
+ * count before LiveTrieReadBegin, and every word below it must then be
+ * found in the section. Run under ASan/TSan this also covers reclamation
+ * (no reader touches retired memory). Afterwards the live trie must dump
+ * like a serial build of the same words. */
+
+#define BASE_WORDS   2000
+#define NEW_WORDS    20000
+#define READERS      3
+#define SYNC_EVERY   4096         /* explicit grace periods, besides the automatic ones */
+
+typedef struct {
+    LiveTrie *lt;
+    char (*words)[16];            /* BASE_WORDS initial words, then NEW_WORDS inserts */
+    volatile long published;      /* inserts that have returned */
+    volatile long done;
+    int failures[READERS + 1];
+    long sections[READERS + 1];
+} LiveJob;
+
+static void Writer(LiveJob *job) {
+    for (long i = 0; i < NEW_WORDS; ++i) {
+        LiveTrieInsert(job->lt, job->words[BASE_WORDS + i]);
+        TrieAtomicStore(&job->published, i + 1);
+        if ((i + 1) % SYNC_EVERY == 0) LiveTrieSynchronize(job->lt);
+        if (i % 64 == 0) TrieYield();             /* let readers in on few cores */
+    }
+    TrieAtomicStore(&job->done, 1);
+}
+
+static void Reader(LiveJob *job, int idx) {
+    LiveReader *reader = LiveTrieReaderJoin(job->lt);
+    TestRng r;
+    r.s = 0x5eed0017ull + (unsigned long long)idx;
+    int *failures = &job->failures[idx];
+
+    for (;;) {
+        int last = TrieAtomicLoad(&job->done) != 0;
+        long seen = TrieAtomicLoad(&job->published);
+        NonLeafPtr root = LiveTrieReadBegin(reader);
+
+        /* a base word, then the newest insert and two random older ones */
+        long probes[4];
+        int nProbes = 0;
+        probes[nProbes++] = (long)TestNext(&r, BASE_WORDS);
+        if (seen > 0) {
+            probes[nProbes++] = BASE_WORDS + seen - 1;
+            probes[nProbes++] = BASE_WORDS + (long)TestNext(&r, (unsigned)seen);
+            probes[nProbes++] = BASE_WORDS + (long)TestNext(&r, (unsigned)seen);
+        }
+        for (int k = 0; k < nProbes; ++k) {
+            char *w = job->words[probes[k]];
+            EXPECT(*failures, SearchTrie(root, w) == success,
+                   "reader %d: `%s` (word %ld, %ld inserts returned) not found", idx, w, probes[k], seen);
+
+            SuggestBox box = { NULL, 0, 0 };
+            SuggestCorrections(root, w, 5, &box);
+            EXPECT(*failures, box.count > 0, "reader %d: no suggestion for `%s`", idx, w);
+            FreeSuggestBox(&box);
+        }
+
+        LiveTrieReadEnd(reader);
+        ++job->sections[idx];
+        if (last || *failures >= 10) break;
+    }
+    LiveTrieReaderLeave(reader);
+}
+
+static void LiveWorker(void *ctx, int idx) {
+    if (idx == 0) Writer((LiveJob*)ctx);
+    else Reader((LiveJob*)ctx, idx);
+}
+
+int TestLiveTrie(void) {
+    TestRng r = { 0x5eed0017ull };
+    LiveJob job;
+    memset(&job, 0, sizeof(job));
+    job.words = (char(*)[16])malloc((BASE_WORDS + NEW_WORDS) * sizeof(*job.words));
+    const char **all = (const char**)malloc((BASE_WORDS + NEW_WORDS) * sizeof(char*));
+    if (!job.words || !all) Error("out of memory: test");
+    for (int i = 0; i < BASE_WORDS + NEW_WORDS; ++i) {
+        TestWord(&r, job.words[i], 1, 12, 10);
+        all[i] = job.words[i];
+    }
+
+    job.lt = LiveTrieCreate(TestBuildSorted(all, BASE_WORDS));
+    TrieRunThreads(READERS + 1, LiveWorker, &job);
+
+    int failures = 0;
+    for (int t = 1; t <= READERS; ++t) {
+        failures += job.failures[t];
+        EXPECT(failures, job.sections[t] > 0, "reader %d never ran", t);
+    }
+
+    /* the final version against a serial build of all the words */
+    LiveReader *reader = LiveTrieReaderJoin(job.lt);
+    NonLeafPtr want = TestBuildSorted(all, BASE_WORDS + NEW_WORDS);
+    long bytesWant, bytesGot;
+    EXPECT(failures, TestSameSideView(want, LiveTrieReadBegin(reader), &bytesWant, &bytesGot),
+           "final trie differs from the serial build (%ld bytes, expected %ld)", bytesGot, bytesWant);
+    LiveTrieReadEnd(reader);
+    LiveTrieReaderLeave(reader);
+
+    TrieDestroy(want);
+    LiveTrieDestroy(job.lt);
+    free((void*)all);
+    free(job.words);
+    return failures;
+}
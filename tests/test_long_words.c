@@ -0,0 +1,155 @@
+#include "tests.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* Words of any length reach the trie through TrieInsert,
+ * TrieBuildFromSorted and the other builders, so the suggestion engines
+ * may not assume a bound on them. A family of 300- and 600-byte words
+ * sharing long prefixes sits next to short words. For the long words,
+ * their one-edit variants and short queries, SuggestCorrections must give
+ * exactly the dictionary words within one edit (brute force), and the
+ * batch, frozen and packed engines the same list in the same order. */
+
+#define SHORT_WORDS  300
+#define LONG_LEN     300
+#define MAX_SUGG     1000
+
+/* Damerau (OSA) distance <= 1, by brute force. */
+static int WithinOneEdit(const char *a, const char *b) {
+    size_t la = strlen(a), lb = strlen(b), i = 0;
+    while (i < la && i < lb && a[i] == b[i]) ++i;
+    if (la == lb) {
+        if (i == la) return 1;
+        if (strcmp(a + i + 1, b + i + 1) == 0) return 1;                 /* substitution */
+        return i + 1 < la && a[i] == b[i + 1] && a[i + 1] == b[i] &&
+               strcmp(a + i + 2, b + i + 2) == 0;                        /* transposition */
+    }
+    if (la == lb + 1) return strcmp(a + i + 1, b + i) == 0;
+    if (lb == la + 1) return strcmp(a + i, b + i + 1) == 0;
+    return 0;
+}
+
+static int CompareStrings(const void *a, const void *b) {
+    return strcmp(*(const char *const *)a, *(const char *const *)b);
+}
+
+/* Do the words of `box` equal the words of `dict` within one edit of q? */
+static int SameAsBruteForce(const SuggestBox *box, const char **dict, size_t n, const char *q) {
+    const char **want = (const char**)malloc(n * sizeof(char*));
+    const char **got = (const char**)malloc(((size_t)box->count + 1) * sizeof(char*));
+    if (!want || !got) Error("out of memory: test");
+
+    size_t nw = 0;
+    for (size_t i = 0; i < n; ++i)
+        if (WithinOneEdit(dict[i], q)) want[nw++] = dict[i];
+    for (int i = 0; i < box->count; ++i) got[i] = box->items[i];
+    qsort((void*)want, nw, sizeof(char*), CompareStrings);
+    qsort((void*)got, (size_t)box->count, sizeof(char*), CompareStrings);
+
+    int same = nw == (size_t)box->count;
+    for (size_t i = 0; same && i < nw; ++i) same = strcmp(want[i], got[i]) == 0;
+    free((void*)want);
+    free((void*)got);
+    return same;
+}
+
+int TestLongWords(void) {
+    TestRng r = { 0x5eed0011ull };
+    int failures = 0;
+
+    /* the dictionary: unique words, short ones and the long family */
+    size_t n = 0, cap = SHORT_WORDS + 16;
+    char **dict = (char**)malloc(cap * sizeof(char*));
+    if (!dict) Error("out of memory: test");
+    for (int i = 0; i < SHORT_WORDS; ++i) {
+        dict[n] = (char*)malloc(16);
+        if (!dict[n]) Error("out of memory: test");
+        TestWord(&r, dict[n++], 1, 10, 4);
+    }
+    char *base = (char*)malloc(2 * LONG_LEN + 2);
+    if (!base) Error("out of memory: test");
+    TestWord(&r, base, LONG_LEN, LONG_LEN, 4);
+    for (int v = 0; v < 7; ++v) {
+        char *w = (char*)malloc(2 * LONG_LEN + 2);
+        if (!w) Error("out of memory: test");
+        strcpy(w, base);
+        switch (v) {
+        case 1: w[LONG_LEN - 1] = w[LONG_LEN - 1] == 'A' ? 'B' : 'A'; break;   /* last byte */
+        case 2: w[LONG_LEN / 2] = 'Z'; break;
+        case 3: strcat(w, "X"); break;                                       /* base is a prefix */
+        case 4: w[LONG_LEN - 1] = '\0'; break;                               /* a prefix of base */
+        case 5: strcat(w, base); break;                                      /* 600 bytes */
+        case 6: strcat(w, base); w[2 * LONG_LEN - 1] = 'Y'; break;
+        default: break;
+        }
+        dict[n++] = w;
+    }
+    qsort(dict, n, sizeof(char*), CompareStrings);
+    size_t u = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (u > 0 && strcmp(dict[u - 1], dict[i]) == 0) { free(dict[i]); continue; }
+        dict[u++] = dict[i];
+    }
+    n = u;
+
+    size_t bad;
+    NonLeafPtr root = TrieBuildFromSorted((const char**)dict, n, &bad);
+    EXPECT(failures, root != NULL, "TrieBuildFromSorted rejected word %zu", bad);
+    if (!root) return failures;
+
+    FrozenTrie *ft = TrieFreeze(root);
+    PackedTrie *pt = PackedTrieCreate();
+    for (size_t i = 0; i < n; ++i) PackedTrieInsert(pt, dict[i]);
+
+    /* queries: every dictionary word and a one-edit variant of it */
+    char *q = (char*)malloc(2 * LONG_LEN + 4);
+    if (!q) Error("out of memory: test");
+    for (size_t i = 0; i < n; ++i)
+        for (int variant = 0; variant < 2; ++variant) {
+            strcpy(q, dict[i]);
+            if (variant) {
+                size_t len = strlen(q), at = TestNext(&r, (unsigned)len);
+                if (TestNext(&r, 2)) q[at] = (char)('A' + TestNext(&r, 4));
+                else memmove(q + at, q + at + 1, len - at);
+                if (!q[0]) continue;
+            }
+
+            SuggestBox box = { NULL, 0, 0 }, frozen = { NULL, 0, 0 }, packed = { NULL, 0, 0 };
+            SuggestCorrections(root, q, MAX_SUGG, &box);
+            SuggestCorrectionsFrozen(ft, q, MAX_SUGG, &frozen);
+            SuggestCorrectionsPacked(pt, q, MAX_SUGG, &packed);
+            EXPECT(failures, SameAsBruteForce(&box, (const char**)dict, n, q),
+                   "SuggestCorrections: %zu-byte query %zu/%d", strlen(q), i, variant);
+            EXPECT(failures, TestSameBox(&box, &frozen),
+                   "SuggestCorrectionsFrozen: %zu-byte query %zu/%d", strlen(q), i, variant);
+            EXPECT(failures, TestSameBox(&box, &packed),
+                   "SuggestCorrectionsPacked: %zu-byte query %zu/%d", strlen(q), i, variant);
+            FreeSuggestBox(&box);
+            FreeSuggestBox(&frozen);
+            FreeSuggestBox(&packed);
+
+            SuggestResult one, batch;
+            const char *words[1];
+            words[0] = q;
+            SuggestResultInit(&one);
+            SuggestResultInit(&batch);
+            SuggestCorrectionsInto(root, q, MAX_SUGG, &one);
+            SuggestCorrectionsBatch(root, words, 1, MAX_SUGG, &batch);
+            int same = one.count == batch.count;
+            for (int k = 0; same && k < one.count; ++k)
+                same = strcmp(SuggestResultWord(&one, k), SuggestResultWord(&batch, k)) == 0;
+            EXPECT(failures, same, "SuggestCorrectionsBatch: %zu-byte query %zu/%d",
+                   strlen(q), i, variant);
+            SuggestResultFree(&one);
+            SuggestResultFree(&batch);
+        }
+
+    FrozenTrieDestroy(ft);
+    PackedTrieDestroy(pt);
+    free(q);
+    free(base);
+    for (size_t i = 0; i < n; ++i) free(dict[i]);
+    free(dict);
+    TrieDestroy(root);
+    return failures;
+}
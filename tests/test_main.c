@@ -0,0 +1,50 @@
+#include "tests.h"
+#include <string.h>
+
+/* Usage: SimpleTrieSpellChecker_tests [name ...]  (no name: run all) */
+
+static const struct {
+    const char *name;
+    int (*run)(void);
+} TESTS[] = {
+    { "spellcheck_parallel", TestSpellCheckParallel },
+    { "delete_index",        TestDeleteIndex },
+    { "parallel_build",      TestParallelBuild },
+    { "long_words",          TestLongWords },
+    { "trie_remove",         TestTrieRemove },
+    { "live_trie",           TestLiveTrie },
+    { "packed",              TestPacked },
+    { "frozen",              TestFrozen },
+    { "complete",            TestComplete },
+    { "ranked",              TestRanked },
+    { "scanner",             TestScanner },
+};
+
+#define TEST_COUNT (int)(sizeof(TESTS) / sizeof(TESTS[0]))
+
+static int Run(int t) {
+    int failures = TESTS[t].run();
+    fprintf(stderr, "%s: %s", TESTS[t].name, failures ? "FAILED" : "ok");
+    if (failures) fprintf(stderr, " (%d)", failures);
+    fputc('\n', stderr);
+    return failures;
+}
+
+int main(int argc, char **argv) {
+    int failed = 0;
+
+    if (argc == 1) {
+        for (int t = 0; t < TEST_COUNT; ++t) failed += Run(t) != 0;
+        return failed != 0;
+    }
+    for (int a = 1; a < argc; ++a) {
+        int t = 0;
+        while (t < TEST_COUNT && strcmp(TESTS[t].name, argv[a]) != 0) ++t;
+        if (t == TEST_COUNT) {
+            fprintf(stderr, "unknown test `%s`\n", argv[a]);
+            return 2;
+        }
+        failed += Run(t) != 0;
+    }
+    return failed != 0;
+}
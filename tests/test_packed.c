@@ -0,0 +1,132 @@
+#include "tests.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* PackedTrie against the pointer trie over the same words: SearchPacked
+ * must agree with SearchTrie, and SuggestCorrectionsPacked must return
+ * SuggestCorrections' list in the same order. One dictionary is random
+ * over a small alphabet; the other is built from long stems, with their
+ * prefixes and short extensions as words, so single-edge chains fold into
+ * long record prefixes that later inserts split and fork. Both are
+ * checked halfway through the inserts and after all of them (and a
+ * PackedTrieTrim). */
+
+#define QUERIES    3000
+#define MAX_WORD   48
+
+static const int MAX_SUGGESTIONS[] = { 3, 1000 };
+
+typedef struct {
+    char (*pool)[MAX_WORD + 1];
+    size_t n;
+} Dict;
+
+static void DictInit(Dict *d, size_t cap) {
+    d->pool = (char(*)[MAX_WORD + 1])malloc(cap * sizeof(*d->pool));
+    if (!d->pool) Error("out of memory: test");
+    d->n = 0;
+}
+
+static void RandomDict(TestRng *r, Dict *d, size_t n) {
+    DictInit(d, n);
+    for (; d->n < n; ++d->n) TestWord(r, d->pool[d->n], 1, 12, 6);
+}
+
+/* Stems of 15-40 letters; each gives itself, a few of its prefixes and a
+ * few extensions by 1-4 letters. */
+static void StemDict(TestRng *r, Dict *d, int stems) {
+    DictInit(d, (size_t)stems * 9);
+    for (int s = 0; s < stems; ++s) {
+        char stem[MAX_WORD + 1];
+        TestWord(r, stem, 15, 40, 26);
+        size_t len = strlen(stem);
+        strcpy(d->pool[d->n++], stem);
+        for (int k = 0; k < 4; ++k) {
+            size_t cut = 1 + TestNext(r, (unsigned)len - 1);
+            memcpy(d->pool[d->n], stem, cut);
+            d->pool[d->n++][cut] = '\0';
+        }
+        for (int k = 0; k < 4; ++k) {
+            strcpy(d->pool[d->n], stem);
+            TestWord(r, d->pool[d->n] + len, 1, 4, 26);
+            ++d->n;
+        }
+    }
+}
+
+/* Compare both tries on queries drawn from the first `known` words. */
+static int CheckQueries(TestRng *r, NonLeafPtr root, const PackedTrie *pt, const Dict *d,
+                        size_t known, const char *what) {
+    int failures = 0;
+    for (int i = 0; i < QUERIES && failures < 10; ++i) {
+        char q[MAX_WORD + 8];
+        TestQuery(r, q, d->pool[TestNext(r, (unsigned)known)], 6);
+        if (!q[0]) continue;
+
+        EXPECT(failures, SearchPacked(pt, q) == SearchTrie(root, q),
+               "%s: SearchPacked(%s) = %d, SearchTrie %d", what, q, SearchPacked(pt, q),
+               SearchTrie(root, q));
+        for (size_t m = 0; m < sizeof(MAX_SUGGESTIONS) / sizeof(MAX_SUGGESTIONS[0]); ++m) {
+            SuggestBox want = { NULL, 0, 0 }, got = { NULL, 0, 0 };
+            SuggestCorrections(root, q, MAX_SUGGESTIONS[m], &want);
+            SuggestCorrectionsPacked(pt, q, MAX_SUGGESTIONS[m], &got);
+            EXPECT(failures, TestSameBox(&want, &got),
+                   "%s, max %d: `%s` gives %d words, SuggestCorrections %d",
+                   what, MAX_SUGGESTIONS[m], q, got.count, want.count);
+            FreeSuggestBox(&want);
+            FreeSuggestBox(&got);
+        }
+    }
+    return failures;
+}
+
+static int CheckDict(TestRng *r, const Dict *d, const char *name) {
+    int failures = 0;
+    size_t half = d->n / 2;
+
+    /* random insertion order, shared by both tries */
+    size_t *order = (size_t*)malloc(d->n * sizeof(size_t));
+    if (!order) Error("out of memory: test");
+    for (size_t i = 0; i < d->n; ++i) order[i] = i;
+    for (size_t i = d->n; i > 1; --i) {
+        size_t j = TestNext(r, (unsigned)i), t = order[i - 1];
+        order[i - 1] = order[j];
+        order[j] = t;
+    }
+
+    Dict seen;                                     /* words in insertion order */
+    DictInit(&seen, d->n);
+    NonLeafPtr root = TrieCreateWithFirstWord(d->pool[order[0]]);
+    PackedTrie *pt = PackedTrieCreate();
+    for (size_t i = 0; i < d->n; ++i) {
+        char *w = d->pool[order[i]];
+        if (i > 0) TrieInsert(w, root);
+        PackedTrieInsert(pt, w);
+        strcpy(seen.pool[seen.n++], w);
+        if (i + 1 == half) failures += CheckQueries(r, root, pt, &seen, seen.n, name);
+    }
+    PackedTrieInsert(pt, d->pool[0]);              /* duplicates are no-ops */
+    PackedTrieTrim(pt);
+    failures += CheckQueries(r, root, pt, &seen, seen.n, name);
+
+    PackedTrieDestroy(pt);
+    TrieDestroy(root);
+    free(seen.pool);
+    free(order);
+    return failures;
+}
+
+int TestPacked(void) {
+    TestRng r = { 0x5eed0020ull };
+    int failures = 0;
+    Dict d;
+
+    RandomDict(&r, &d, 6000);
+    failures += CheckDict(&r, &d, "random");
+    free(d.pool);
+
+    StemDict(&r, &d, 300);
+    failures += CheckDict(&r, &d, "stems");
+    free(d.pool);
+    return failures;
+}
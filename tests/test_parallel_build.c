@@ -0,0 +1,120 @@
+#include "tests.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* TrieBuildParallel must build the trie of the serial
+ * TrieCreateWithFirstWord + TrieInsert loop for every thread count: the
+ * TrieSideView dumps of both must be byte for byte the same. The word
+ * lists cover duplicates, empty words, bytes >= 0x80 (also as first byte,
+ * where `char` order puts them before 'A'), already sorted input and a
+ * single shard. */
+
+#define MAX_WORD    24
+
+static const int THREADS[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 64 };
+
+typedef struct {
+    const char *name;
+    char (*pool)[MAX_WORD + 1];
+    const char **words;
+    size_t n;
+} WordList;
+
+static void ListInit(WordList *l, const char *name, size_t n) {
+    l->name = name;
+    l->n = n;
+    l->pool = (char(*)[MAX_WORD + 1])calloc(n, sizeof(*l->pool));
+    l->words = (const char**)malloc(n * sizeof(char*));
+    if (!l->pool || !l->words) Error("out of memory: test");
+    for (size_t i = 0; i < n; ++i) l->words[i] = l->pool[i];
+}
+
+static void ListFree(WordList *l) {
+    free(l->pool);
+    free((void*)l->words);
+}
+
+static int CompareWords(const void *a, const void *b) {
+    return strcmp(*(const char *const *)a, *(const char *const *)b);
+}
+
+/* Random words; about one in `dupEvery` repeats an earlier word. */
+static void RandomWords(TestRng *r, WordList *l, int alphabet, unsigned dupEvery) {
+    for (size_t i = 0; i < l->n; ++i) {
+        if (i > 0 && TestNext(r, dupEvery) == 0)
+            strcpy(l->pool[i], l->pool[TestNext(r, (unsigned)i)]);
+        else
+            TestWord(r, l->pool[i], 1, 12, alphabet);
+    }
+}
+
+/* The serial reference; words are inserted in list order. */
+static NonLeafPtr BuildSerial(const WordList *l) {
+    size_t first = 0;
+    while (first < l->n && !l->words[first][0]) ++first;
+    if (first == l->n) Error("test: no non-empty word");
+
+    NonLeafPtr root = TrieCreateWithFirstWord(l->pool[first]);
+    for (size_t i = 0; i < l->n; ++i)
+        if (i != first) TrieInsert(l->pool[i], root);
+    return root;
+}
+
+static int CheckList(const WordList *l) {
+    int failures = 0;
+
+    NonLeafPtr serial = BuildSerial(l);
+    for (size_t t = 0; t < sizeof(THREADS) / sizeof(THREADS[0]); ++t) {
+        NonLeafPtr par = TrieBuildParallel(l->words, l->n, THREADS[t]);
+        long bytesSerial, bytesPar;
+        EXPECT(failures, TestSameSideView(serial, par, &bytesSerial, &bytesPar) && bytesSerial > 0,
+               "%s, %d threads: TrieSideView differs (%ld bytes serial, %ld parallel)",
+               l->name, THREADS[t], bytesSerial, bytesPar);
+        TrieDestroy(par);
+    }
+    TrieDestroy(serial);
+    return failures;
+}
+
+int TestParallelBuild(void) {
+    TestRng r = { 0x5eed0025ull };
+    int failures = 0;
+    WordList l;
+
+    ListInit(&l, "random, duplicates", 20000);
+    RandomWords(&r, &l, 26, 8);
+    failures += CheckList(&l);
+
+    qsort((void*)l.words, l.n, sizeof(char*), CompareWords);
+    l.name = "sorted";
+    failures += CheckList(&l);
+    ListFree(&l);
+
+    ListInit(&l, "empty words", 5000);
+    RandomWords(&r, &l, 6, 16);
+    for (size_t i = 0; i < l.n; i += 97) l.pool[i][0] = '\0';
+    failures += CheckList(&l);
+    ListFree(&l);
+
+    /* letters and bytes 0x80..0xFF, first byte included */
+    ListInit(&l, "bytes >= 0x80", 10000);
+    RandomWords(&r, &l, 4, 10);
+    for (size_t i = 0; i < l.n; ++i)
+        for (char *c = l.pool[i]; *c; ++c)
+            if (TestNext(&r, 3) == 0) *c = (char)(0x80 + TestNext(&r, 0x80));
+    failures += CheckList(&l);
+    ListFree(&l);
+
+    /* one shard: every word starts with the same byte */
+    ListInit(&l, "one shard", 3000);
+    RandomWords(&r, &l, 5, 20);
+    for (size_t i = 0; i < l.n; ++i) l.pool[i][0] = 'Q';
+    failures += CheckList(&l);
+    ListFree(&l);
+
+    ListInit(&l, "one word", 1);
+    strcpy(l.pool[0], "WORD");
+    failures += CheckList(&l);
+    ListFree(&l);
+    return failures;
+}
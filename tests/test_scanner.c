@@ -0,0 +1,167 @@
+#include "tests.h"
+#include "TextScan.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* Every tokenizer level (SpellCheckScanner) must give the records of the
+ * scalar one: same offsets, lengths and lines from SpellCheckBuffer, and
+ * the same suggestions from SpellCheckBufferParallel, whose uppercasing
+ * goes through the level's ScanUpperCopy (checked on its own as well,
+ * over all byte values). The buffers mix ASCII words in any case, CRLF
+ * and LF line breaks, punctuation, valid UTF-8 letters and non-letters of
+ * 2-4 bytes and malformed UTF-8, with tokens of up to 80 bytes; each is
+ * checked from several start offsets and cut at several lengths, so
+ * tokens and sequences cross every 16-, 32- and 64-byte boundary and the
+ * buffer end. Levels the CPU or build lacks are skipped. */
+
+#define DICT_WORDS   500
+#define BUFFERS      60
+#define BUFFER_BYTES 4096
+#define MAX_SUGG     3
+
+static const char *SEPARATORS[] = { " ", ", ", ". ", "\n", "\r\n", "\r\n\r\n", " 42 ", "\t", "'" };
+
+/* é Ж λ ש ß ḁ (letters), — NBSP € 中 😀 (not letters) */
+static const char *UTF8[] = { "\xC3\xA9", "\xD0\x96", "\xCE\xBB", "\xD7\xA9", "\xC3\x9F",
+                              "\xE1\xB8\x81", "\xE2\x80\x94", "\xC2\xA0", "\xE2\x82\xAC",
+                              "\xE4\xB8\xAD", "\xF0\x9F\x98\x80" };
+
+/* lone continuation, truncated sequences, overlong, surrogate, > U+10FFFF */
+static const char *MALFORMED[] = { "\x80", "\xBF", "\xC3", "\xE2\x82", "\xF0\x9F\x98", "\xC0\xAF",
+                                   "\xE0\x80\xAF", "\xED\xA0\x80", "\xF4\x90\x80\x80", "\xFF" };
+
+#define COUNT(a) (unsigned)(sizeof(a) / sizeof((a)[0]))
+
+/* Append s, cut at BUFFER_BYTES (possibly mid-sequence). */
+static void Append(char *t, size_t *n, const char *s) {
+    size_t l = strlen(s);
+    if (l > BUFFER_BYTES - *n) l = BUFFER_BYTES - *n;
+    memcpy(t + *n, s, l);
+    *n += l;
+}
+
+static size_t MakeBuffer(TestRng *r, char *t, char (*dict)[16]) {
+    size_t n = 0;
+    while (n < BUFFER_BYTES) {
+        char w[96];
+        unsigned kind = TestNext(r, 12);
+        if (kind < 6) {
+            strcpy(w, dict[TestNext(r, DICT_WORDS)]);
+            if (kind == 0) w[0] = (char)('A' + TestNext(r, 26));                 /* typo */
+        } else if (kind < 8) {
+            TestWord(r, w, 12, 80, 26);                                         /* long token */
+        } else if (kind < 10) {
+            TestWord(r, w, 0, 6, 26);
+            Append(t, &n, w);
+            strcpy(w, UTF8[TestNext(r, COUNT(UTF8))]);                          /* mid-token */
+        } else {
+            TestWord(r, w, 0, 6, 26);
+            Append(t, &n, w);
+            strcpy(w, MALFORMED[TestNext(r, COUNT(MALFORMED))]);
+        }
+        for (char *c = w; *c; ++c)
+            if ((unsigned char)*c < 0x80 && TestNext(r, 3) == 0) *c = (char)(*c - 'A' + 'a');
+        Append(t, &n, w);
+        if (TestNext(r, 4)) Append(t, &n, SEPARATORS[TestNext(r, COUNT(SEPARATORS))]);
+    }
+    return BUFFER_BYTES;
+}
+
+static int SameLists(const MisspellingList *a, const MisspellingList *b) {
+    if (a->count != b->count) return 0;
+    for (size_t i = 0; i < a->count; ++i) {
+        const Misspelling *x = &a->items[i], *y = &b->items[i];
+        if (x->offset != y->offset || x->length != y->length || x->line != y->line ||
+            !TestSameBox(&x->suggestions, &y->suggestions))
+            return 0;
+    }
+    return 1;
+}
+
+/* Check buf[0..len) (copied to an exact-size block, so reads past the end
+ * show up under a sanitizer) with every level against the scalar one. */
+static int CheckSlice(NonLeafPtr root, const char *buf, size_t len, const int *levels,
+                      int nLevels, size_t *records) {
+    int failures = 0;
+    char *copy = (char*)malloc(len ? len : 1);
+    if (!copy) Error("out of memory: test");
+    memcpy(copy, buf, len);
+
+    MisspellingList want = { NULL, 0, 0 }, wantSugg = { NULL, 0, 0 };
+    SpellCheckScanner(scanScalar);
+    SpellCheckBuffer(root, copy, len, &want);
+    SpellCheckBufferParallel(root, copy, len, 1, MAX_SUGG, NULL, &wantSugg);
+    *records += want.count;
+
+    for (int l = 0; l < nLevels; ++l) {
+        MisspellingList got = { NULL, 0, 0 }, gotSugg = { NULL, 0, 0 };
+        SpellCheckScanner(levels[l]);
+        SpellCheckBuffer(root, copy, len, &got);
+        SpellCheckBufferParallel(root, copy, len, 1, MAX_SUGG, NULL, &gotSugg);
+        EXPECT(failures, SameLists(&want, &got),
+               "level %d, %zu bytes: %zu records, scalar %zu (or they differ)", levels[l], len,
+               got.count, want.count);
+        EXPECT(failures, SameLists(&wantSugg, &gotSugg),
+               "level %d, %zu bytes: other records or suggestions than scalar", levels[l], len);
+        FreeMisspellingList(&got);
+        FreeMisspellingList(&gotSugg);
+    }
+
+    FreeMisspellingList(&want);
+    FreeMisspellingList(&wantSugg);
+    free(copy);
+    return failures;
+}
+
+static int CheckUpper(TestRng *r, const int *levels, int nLevels) {
+    int failures = 0;
+    char src[160], want[160], got[160];
+    for (int i = 0; i < 2000 && failures < 10; ++i) {
+        size_t n = TestNext(r, 129), at = TestNext(r, 32);
+        for (size_t k = 0; k < n; ++k) src[at + k] = (char)TestNext(r, 256);
+        SpellCheckScanner(scanScalar);
+        ScanUpperCopy(want, src + at, n);
+        for (int l = 0; l < nLevels; ++l) {
+            SpellCheckScanner(levels[l]);
+            ScanUpperCopy(got + at, src + at, n);
+            EXPECT(failures, memcmp(want, got + at, n) == 0,
+                   "level %d: ScanUpperCopy of %zu bytes differs from scalar", levels[l], n);
+        }
+    }
+    return failures;
+}
+
+int TestScanner(void) {
+    TestRng r = { 0x5eed0021ull };
+    int failures = 0;
+
+    int levels[2], nLevels = 0;
+    for (int level = scanSSE2; level <= scanAVX2; ++level)
+        if (SpellCheckScanner(level) == level) levels[nLevels++] = level;
+    fprintf(stderr, "  %d vectorized level(s) to compare\n", nLevels);
+
+    char (*dict)[16] = (char(*)[16])malloc(DICT_WORDS * sizeof(*dict));
+    char *text = (char*)malloc(BUFFER_BYTES + 128);
+    if (!dict || !text) Error("out of memory: test");
+    for (int i = 0; i < DICT_WORDS; ++i) TestWord(&r, dict[i], 2, 9, 26);
+    NonLeafPtr root = TrieCreateWithFirstWord(dict[0]);
+    for (int i = 1; i < DICT_WORDS; ++i) TrieInsert(dict[i], root);
+
+    size_t records = 0;
+    for (int b = 0; b < BUFFERS && failures < 10; ++b) {
+        size_t len = MakeBuffer(&r, text, dict);
+        for (int s = 0; s < 4; ++s) {
+            size_t start = TestNext(&r, 64), cut = TestNext(&r, (unsigned)(len - start) + 1);
+            failures += CheckSlice(root, text + start, len - start, levels, nLevels, &records);
+            failures += CheckSlice(root, text + start, cut, levels, nLevels, &records);
+        }
+    }
+    EXPECT(failures, records > 10000, "only %zu misspellings checked", records);
+    failures += CheckUpper(&r, levels, nLevels);
+
+    SpellCheckScanner(scanAuto);
+    TrieDestroy(root);
+    free(text);
+    free(dict);
+    return failures;
+}
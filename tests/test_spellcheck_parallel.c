@@ -0,0 +1,116 @@
+#include "tests.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* SpellCheckBufferParallel must give the records of SpellCheckBuffer
+ * (offset, length, line) for every thread count, each with the words
+ * SuggestCorrections returns for its token, with or without a shared
+ * SuggestCache. The corpus mixes dictionary words in any case, typos,
+ * punctuation, digits, line breaks and UTF-8 letters, and is long enough
+ * to be cut into several chunks. */
+
+#define DICT_WORDS   4000
+#define TEXT_BYTES   (640u << 10)
+#define MAX_SUGG     5
+#define MAX_THREADS  8
+
+static const char *SEPARATORS[] = { " ", " ", " ", ", ", ". ", "\n", "\r\n", " 42 ", " - " };
+static const char *UTF8_LETTERS[] = { "\xC3\xA9", "\xC3\x9F", "\xC5\x82", "\xD0\x96" };   /* é ß ł Ж */
+
+static char *MakeText(TestRng *r, char (*dict)[16], size_t *len) {
+    char *t = (char*)malloc(TEXT_BYTES + 64);
+    size_t n = 0;
+    if (!t) Error("out of memory: test");
+
+    while (n < TEXT_BYTES) {
+        char w[16];
+        strcpy(w, dict[TestNext(r, DICT_WORDS)]);
+        unsigned kind = TestNext(r, 10);
+        size_t wl = strlen(w);
+        if (kind < 2) w[TestNext(r, (unsigned)wl)] = (char)('A' + TestNext(r, 14));   /* typo */
+        else if (kind == 2 && wl > 1) w[wl - 1] = '\0';                                /* cut */
+        for (char *c = w; *c; ++c)
+            if (TestNext(r, 3) == 0) *c = (char)(*c - 'A' + 'a');
+
+        memcpy(t + n, w, strlen(w));
+        n += strlen(w);
+        if (kind == 3) {                                  /* a letter outside ASCII */
+            const char *u = UTF8_LETTERS[TestNext(r, 4)];
+            memcpy(t + n, u, strlen(u));
+            n += strlen(u);
+        }
+        const char *sep = SEPARATORS[TestNext(r, (unsigned)(sizeof(SEPARATORS) / sizeof(SEPARATORS[0])))];
+        memcpy(t + n, sep, strlen(sep));
+        n += strlen(sep);
+    }
+    *len = n;
+    return t;
+}
+
+/* Count the records of `got` that differ from `want`. */
+static int CompareLists(const MisspellingList *want, const MisspellingList *got,
+                        const char *what, int threads) {
+    int failures = 0;
+    EXPECT(failures, got->count == want->count, "%s, %d threads: %zu records, expected %zu",
+           what, threads, got->count, want->count);
+    for (size_t i = 0; i < want->count && i < got->count && failures < 10; ++i) {
+        const Misspelling *a = &want->items[i], *b = &got->items[i];
+        EXPECT(failures, a->offset == b->offset && a->length == b->length && a->line == b->line,
+               "%s, %d threads: record %zu is (%zu, %zu, line %zu), expected (%zu, %zu, line %zu)",
+               what, threads, i, b->offset, b->length, b->line, a->offset, a->length, a->line);
+
+        int same = a->suggestions.count == b->suggestions.count;
+        for (int k = 0; same && k < a->suggestions.count; ++k)
+            same = strcmp(a->suggestions.items[k], b->suggestions.items[k]) == 0;
+        EXPECT(failures, same, "%s, %d threads: record %zu has other suggestions (%d, expected %d)",
+               what, threads, i, b->suggestions.count, a->suggestions.count);
+    }
+    return failures;
+}
+
+int TestSpellCheckParallel(void) {
+    TestRng r = { 0x5eed0008ull };
+    char (*dict)[16] = (char(*)[16])malloc(DICT_WORDS * sizeof(*dict));
+    if (!dict) Error("out of memory: test");
+    for (int i = 0; i < DICT_WORDS; ++i) TestWord(&r, dict[i], 2, 9, 14);
+
+    NonLeafPtr root = TrieCreateWithFirstWord(dict[0]);
+    for (int i = 1; i < DICT_WORDS; ++i) TrieInsert(dict[i], root);
+
+    size_t len;
+    char *text = MakeText(&r, dict, &len);
+
+    /* reference: serial records, suggestions per token */
+    MisspellingList want = { NULL, 0, 0 };
+    SpellCheckBuffer(root, text, len, &want);
+    for (size_t i = 0; i < want.count; ++i) {
+        Misspelling *ms = &want.items[i];
+        char *tok = (char*)malloc(ms->length + 1);
+        if (!tok) Error("out of memory: test");
+        memcpy(tok, text + ms->offset, ms->length);
+        tok[ms->length] = '\0';
+        SuggestCorrections(root, strupr_local(tok), MAX_SUGG, &ms->suggestions);
+        free(tok);
+    }
+
+    int failures = 0;
+    EXPECT(failures, want.count > 1000, "only %zu misspellings in the corpus", want.count);
+
+    SuggestCache *cache = SuggestCacheCreate(root, 1u << 20);
+    for (int threads = 1; threads <= MAX_THREADS; ++threads) {
+        MisspellingList plain = { NULL, 0, 0 }, cached = { NULL, 0, 0 };
+        SpellCheckBufferParallel(root, text, len, threads, MAX_SUGG, NULL, &plain);
+        SpellCheckBufferParallel(root, text, len, threads, MAX_SUGG, cache, &cached);
+        failures += CompareLists(&want, &plain, "no cache", threads);
+        failures += CompareLists(&want, &cached, "SuggestCache", threads);
+        FreeMisspellingList(&plain);
+        FreeMisspellingList(&cached);
+    }
+
+    SuggestCacheDestroy(cache);
+    FreeMisspellingList(&want);
+    free(text);
+    free(dict);
+    TrieDestroy(root);
+    return failures;
+}
@@ -0,0 +1,125 @@
+#include "tests.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* TrieRemove must leave the trie TrieBuildFromSorted builds from the
+ * remaining words (same TrieSideView dump): collapsed leaves, shrunk edge
+ * blocks and compacted suffixes included. Rounds remove random shares of
+ * the words (up to all of them), try words that are absent or only a
+ * prefix, then reinsert part of what was removed; at the end everything
+ * goes back in and the trie must be the full dictionary again. A small
+ * alphabet makes many words prefixes of others; a few carry bytes >= 0x80. */
+
+#define DICT_WORDS 4000
+#define ROUNDS     8
+#define MAX_WORD   12
+
+static int CompareStrings(const void *a, const void *b) {
+    return strcmp(*(const char *const *)a, *(const char *const *)b);
+}
+
+static void Shuffle(TestRng *r, size_t *v, size_t n) {
+    for (size_t i = n; i > 1; --i) {
+        size_t j = TestNext(r, (unsigned)i), t = v[i - 1];
+        v[i - 1] = v[j];
+        v[j] = t;
+    }
+}
+
+/* Does `root` match the trie built from the present words? */
+static int CheckShape(NonLeafPtr root, char **words, const int *present, size_t n,
+                      const char *what, int round) {
+    const char **live = (const char**)malloc((n ? n : 1) * sizeof(char*));
+    if (!live) Error("out of memory: test");
+    size_t m = 0;
+    for (size_t i = 0; i < n; ++i)
+        if (present[i]) live[m++] = words[i];
+
+    NonLeafPtr want = TestBuildSorted(live, m);
+    long bytesWant, bytesGot;
+    int failures = 0;
+    EXPECT(failures, TestSameSideView(want, root, &bytesWant, &bytesGot),
+           "round %d, %s (%zu words left): TrieSideView differs (%ld bytes, expected %ld)",
+           round, what, m, bytesGot, bytesWant);
+    if (want) TrieDestroy(want);
+    free((void*)live);
+    return failures;
+}
+
+int TestTrieRemove(void) {
+    TestRng r = { 0x5eed0018ull };
+    int failures = 0;
+
+    /* distinct words */
+    char (*pool)[MAX_WORD + 1] = (char(*)[MAX_WORD + 1])malloc(DICT_WORDS * sizeof(*pool));
+    char **words = (char**)malloc(DICT_WORDS * sizeof(char*));
+    int *present = (int*)malloc(DICT_WORDS * sizeof(int));
+    size_t *order = (size_t*)malloc(DICT_WORDS * sizeof(size_t));
+    if (!pool || !words || !present || !order) Error("out of memory: test");
+    for (size_t i = 0; i < DICT_WORDS; ++i) {
+        TestWord(&r, pool[i], 1, 10, 5);
+        if (TestNext(&r, 20) == 0) pool[i][TestNext(&r, (unsigned)strlen(pool[i]))] = (char)0xC4;
+        words[i] = pool[i];
+    }
+    qsort(words, DICT_WORDS, sizeof(char*), CompareStrings);
+    size_t n = 0;
+    for (size_t i = 0; i < DICT_WORDS; ++i)
+        if (n == 0 || strcmp(words[n - 1], words[i]) != 0) words[n++] = words[i];
+
+    /* serial build in random order */
+    for (size_t i = 0; i < n; ++i) order[i] = i;
+    Shuffle(&r, order, n);
+    NonLeafPtr root = TrieCreateWithFirstWord(words[order[0]]);
+    for (size_t i = 1; i < n; ++i) TrieInsert(words[order[i]], root);
+    for (size_t i = 0; i < n; ++i) present[i] = 1;
+
+    for (int round = 0; round < ROUNDS; ++round) {
+        /* remove a share of the present words: 10% up to all of them */
+        unsigned share = round == ROUNDS - 1 ? 100 : 10 + TestNext(&r, 90);
+        Shuffle(&r, order, n);
+        for (size_t i = 0; i < n; ++i) {
+            size_t w = order[i];
+            if (!present[w] || TestNext(&r, 100) >= share) continue;
+            EXPECT(failures, TrieRemove(root, words[w]) == success,
+                   "round %d: TrieRemove(%s) failed", round, words[w]);
+            present[w] = 0;
+        }
+
+        /* absent words and mere prefixes are not found, nothing changes */
+        for (int i = 0; i < 200; ++i) {
+            char w[MAX_WORD + 1];
+            TestWord(&r, w, 1, 11, 5);
+            const char *key = w;
+            char **hit = (char**)bsearch(&key, words, n, sizeof(char*), CompareStrings);
+            if (hit && present[hit - words]) continue;
+            EXPECT(failures, TrieRemove(root, w) == notFound,
+                   "round %d: TrieRemove(%s) of an absent word succeeded", round, w);
+        }
+        failures += CheckShape(root, words, present, n, "after removals", round);
+
+        /* reinsert some of the removed words */
+        for (size_t i = 0; i < n; ++i) {
+            size_t w = order[i];
+            if (present[w] || TestNext(&r, 3) != 0) continue;
+            TrieInsert(words[w], root);
+            present[w] = 1;
+        }
+        failures += CheckShape(root, words, present, n, "after reinserting", round);
+        if (failures) break;
+    }
+
+    /* everything back */
+    for (size_t i = 0; i < n; ++i)
+        if (!present[i]) {
+            TrieInsert(words[i], root);
+            present[i] = 1;
+        }
+    failures += CheckShape(root, words, present, n, "all reinserted", ROUNDS);
+
+    TrieDestroy(root);
+    free(order);
+    free(present);
+    free(words);
+    free(pool);
+    return failures;
+}
@@ -0,0 +1,87 @@
+#include "tests.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define DUMP_FILE "tests.dump"
+
+/* TrieSideView of `root` (none for NULL) into stdout at its offset. */
+static long Dump(NonLeafPtr root) {
+    char prefix[TEST_MAX_WORD + 2];
+    prefix[0] = '\0';
+    if (root) TrieSideView(0, root, prefix);
+    fflush(stdout);
+    return ftell(stdout);
+}
+
+int TestSameSideView(NonLeafPtr a, NonLeafPtr b, long *bytesA, long *bytesB) {
+    if (!freopen(DUMP_FILE, "w+", stdout)) Error("test: can't open " DUMP_FILE);
+    long mid = Dump(a);
+    long end = Dump(b);
+
+    char *dump = (char*)malloc((size_t)end + 1);
+    if (!dump) Error("out of memory: test");
+    rewind(stdout);
+    size_t got = fread(dump, 1, (size_t)end, stdout);
+    int same = got == (size_t)end && end == 2 * mid && memcmp(dump, dump + mid, (size_t)mid) == 0;
+    free(dump);
+
+    if (bytesA) *bytesA = mid;
+    if (bytesB) *bytesB = end - mid;
+    remove(DUMP_FILE);              /* may fail where open files can't be removed */
+    return same;
+}
+
+static int CompareTrieOrder(const void *a, const void *b) {
+    const char *x = *(const char *const *)a, *y = *(const char *const *)b;
+    while (*x && *x == *y) ++x, ++y;
+    if (*x == *y) return 0;
+    if (!*x || !*y) return *x ? 1 : -1;                   /* a prefix first */
+    return *x < *y ? -1 : 1;                              /* then `char` order, as in the trie */
+}
+
+NonLeafPtr TestBuildSorted(const char *const *words, size_t n) {
+    const char **w = (const char**)malloc((n ? n : 1) * sizeof(char*));
+    if (!w) Error("out of memory: test");
+    memcpy((void*)w, words, n * sizeof(char*));
+    qsort((void*)w, n, sizeof(char*), CompareTrieOrder);
+
+    size_t u = 0;
+    for (size_t i = 0; i < n; ++i)
+        if (w[i][0] && (u == 0 || strcmp(w[u - 1], w[i]) != 0)) w[u++] = w[i];
+
+    size_t bad;
+    NonLeafPtr root = u ? TrieBuildFromSorted(w, u, &bad) : NULL;
+    if (u && !root) Error("test: TrieBuildFromSorted rejected its input");
+    free((void*)w);
+    return root;
+}
+
+int TestSameBox(const SuggestBox *a, const SuggestBox *b) {
+    if (a->count != b->count) return 0;
+    for (int i = 0; i < a->count; ++i)
+        if (strcmp(a->items[i], b->items[i]) != 0) return 0;
+    return 1;
+}
+
+void TestEdit(TestRng *r, char *w, int alphabet) {
+    size_t n = strlen(w);
+    size_t i = TestNext(r, (unsigned)n + 1);
+    char c = (char)('A' + TestNext(r, (unsigned)alphabet));
+    switch (TestNext(r, 4)) {
+    case 0: if (i < n) w[i] = c; break;
+    case 1: memmove(w + i + 1, w + i, n - i + 1); w[i] = c; break;
+    case 2: if (i < n) memmove(w + i, w + i + 1, n - i); break;
+    default:
+        if (i + 1 < n) { char t = w[i]; w[i] = w[i + 1]; w[i + 1] = t; }
+        break;
+    }
+}
+
+void TestQuery(TestRng *r, char *q, const char *word, int alphabet) {
+    unsigned kind = TestNext(r, 10);
+    strcpy(q, word);
+    if (kind < 3) TestEdit(r, q, alphabet);                       /* one edit */
+    else if (kind < 5) { TestEdit(r, q, alphabet); TestEdit(r, q, alphabet); }
+    else if (kind < 7) q[TestNext(r, (unsigned)strlen(q)) + 1] = '\0';  /* a prefix */
+    else if (kind == 7) TestWord(r, q, 1, 12, alphabet);          /* unrelated */
+}
@@ -0,0 +1,268 @@
+#include "tests.h"
+#include "TrieNode.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* The weight-ordered searches against brute force over random weighted
+ * dictionaries. TrieComplete must return the k heaviest words with the
+ * prefix, heaviest first and equal weights alphabetically, whatever its
+ * bounds pruned. SuggestCorrectionsRanked must return SuggestCorrections'
+ * candidates, each scored by its edit kind and weight as documented, best
+ * score first, and with a small maximum the best scores. A dictionary
+ * mixes short words over a small alphabet (dense, many ties: weights are
+ * mostly 0-3) with long words that extend them, so many prefixes end
+ * inside a leaf's suffix; some words are inserted twice, their weights
+ * adding up. */
+
+#define ENTRIES    4000
+#define QUERIES    2000
+#define MAX_WORD   32
+
+static const int COMPLETE_K[] = { 1, 3, 10, 50, ENTRIES };
+static const int RANKED_MAX[] = { 1, 3, 10 };
+
+typedef struct {
+    char word[MAX_WORD + 1];
+    unsigned int weight;
+} Entry;
+
+typedef struct {
+    Entry *e;                     /* distinct words, heaviest first */
+    size_t n;
+} WeightedDict;
+
+static unsigned int RandomWeight(TestRng *r) {
+    return TestNext(r, 10) ? TestNext(r, 4) : TestNext(r, 1000);
+}
+
+static int CompareWord(const void *a, const void *b) {
+    return strcmp(((const Entry*)a)->word, ((const Entry*)b)->word);
+}
+
+static int CompareHeaviest(const void *a, const void *b) {
+    const Entry *x = (const Entry*)a, *y = (const Entry*)b;
+    if (x->weight != y->weight) return x->weight > y->weight ? -1 : 1;
+    return strcmp(x->word, y->word);
+}
+
+/* Insert ENTRIES random words with random weights into a new trie; the
+ * distinct words with their summed weights go to d. */
+static NonLeafPtr BuildWeighted(TestRng *r, WeightedDict *d) {
+    Entry *e = (Entry*)malloc(ENTRIES * sizeof(Entry));
+    if (!e) Error("out of memory: test");
+
+    NonLeafPtr root = NULL;
+    for (size_t i = 0; i < ENTRIES; ++i) {
+        if (i && TestNext(r, 10) == 0) {
+            strcpy(e[i].word, e[TestNext(r, (unsigned)i)].word);      /* again: weights add */
+        } else {
+            TestWord(r, e[i].word, 1, 8, 5);
+            if (TestNext(r, 4) == 0) {                                /* long tail */
+                size_t len = strlen(e[i].word);
+                TestWord(r, e[i].word + len, 8, MAX_WORD - (int)len, 26);
+            }
+        }
+        e[i].weight = RandomWeight(r);
+        if (!root) root = TrieCreateWithFirstWord(e[i].word);
+        TrieInsertWeighted(e[i].word, e[i].weight, root);
+    }
+
+    qsort(e, ENTRIES, sizeof(Entry), CompareWord);
+    size_t u = 0;
+    for (size_t i = 0; i < ENTRIES; ++i) {
+        if (u && strcmp(e[u - 1].word, e[i].word) == 0) e[u - 1].weight += e[i].weight;
+        else                                            e[u++] = e[i];
+    }
+    qsort(e, u, sizeof(Entry), CompareHeaviest);
+    d->e = e;
+    d->n = u;
+    return root;
+}
+
+/* Does the trie walk for `prefix` end inside a leaf's suffix? */
+static int EndsInLeaf(NonLeafPtr root, const char *prefix) {
+    NonLeafPtr p = root;
+    for (size_t i = 0; prefix[i]; ++i) {
+        if (p->kind == leaf) return 1;
+        int pos = Position(p, prefix[i]);
+        if (pos == notFound || !p->ptrs[pos]) return 0;
+        p = p->ptrs[pos];
+    }
+    return 0;
+}
+
+/* A prefix of a dictionary word (often with its last letter changed), or
+ * a random one. */
+static void RandomPrefix(TestRng *r, char *q, const WeightedDict *d) {
+    if (TestNext(r, 8) == 0) {
+        TestWord(r, q, 0, 4, 5);
+        return;
+    }
+    const char *w = d->e[TestNext(r, (unsigned)d->n)].word;
+    size_t cut = TestNext(r, (unsigned)strlen(w) + 1);
+    memcpy(q, w, cut);
+    q[cut] = '\0';
+    if (cut && TestNext(r, 4) == 0) q[cut - 1] = (char)('A' + TestNext(r, 26));
+}
+
+static int CheckComplete(TestRng *r, NonLeafPtr root, const WeightedDict *d) {
+    int failures = 0, inLeaf = 0;
+    SuggestResult res;
+    SuggestResultInit(&res);
+
+    for (int i = 0; i < QUERIES && failures < 10; ++i) {
+        char q[MAX_WORD + 1];
+        RandomPrefix(r, q, d);
+        size_t plen = strlen(q);
+        inLeaf += EndsInLeaf(root, q);
+
+        for (size_t m = 0; m < sizeof(COMPLETE_K) / sizeof(COMPLETE_K[0]); ++m) {
+            int k = COMPLETE_K[m], got = 0;
+            TrieComplete(root, q, k, &res);
+            for (size_t j = 0; j < d->n && got < k; ++j) {
+                if (strncmp(d->e[j].word, q, plen) != 0) continue;
+                EXPECT(failures, got < res.count && strcmp(SuggestResultWord(&res, got), d->e[j].word) == 0,
+                       "TrieComplete(`%s`, %d): #%d is `%s`, expected `%s` (weight %u)", q, k, got,
+                       got < res.count ? SuggestResultWord(&res, got) : "(none)", d->e[j].word,
+                       d->e[j].weight);
+                ++got;
+            }
+            EXPECT(failures, res.count == got, "TrieComplete(`%s`, %d) gives %d words, expected %d",
+                   q, k, res.count, got);
+        }
+    }
+    EXPECT(failures, inLeaf >= QUERIES / 10, "only %d prefixes end inside a leaf suffix", inLeaf);
+
+    SuggestResultFree(&res);
+    return failures;
+}
+
+int TestComplete(void) {
+    TestRng r;
+    r.s = 0x636f6d706c657465ull;
+    int failures = 0;
+
+    WeightedDict d;
+    NonLeafPtr root = BuildWeighted(&r, &d);
+    for (size_t i = 0; i < d.n; ++i)
+        EXPECT(failures, TrieWordWeight(root, d.e[i].word) == d.e[i].weight,
+               "TrieWordWeight(%s) = %u, expected %u", d.e[i].word,
+               TrieWordWeight(root, d.e[i].word), d.e[i].weight);
+
+    failures += CheckComplete(&r, root, &d);
+
+    TrieDestroy(root);
+    free(d.e);
+    return failures;
+}
+
+/* Score SuggestCorrectionsRanked gives `w` for query q: (weight + 1)
+ * times 16 if equal, 8 for an adjacent transposition, 5 for an inserted
+ * or deleted letter, 4 for a substitution; 0 if not within one edit. */
+static unsigned long long BruteScore(const char *w, unsigned int weight, const char *q) {
+    size_t lw = strlen(w), lq = strlen(q), i = 0;
+    unsigned long long factor = 0;
+    while (w[i] && w[i] == q[i]) ++i;
+    if (lw == lq) {
+        if (i == lw)                                                    factor = 16;
+        else if (strcmp(w + i + 1, q + i + 1) == 0)                     factor = 4;
+        else if (w[i] == q[i + 1] && w[i + 1] == q[i] && strcmp(w + i + 2, q + i + 2) == 0)
+                                                                        factor = 8;
+    } else if (lw + 1 == lq) {
+        if (strcmp(w + i, q + i + 1) == 0)                              factor = 5;
+    } else if (lq + 1 == lw) {
+        if (strcmp(w + i + 1, q + i) == 0)                              factor = 5;
+    }
+    return factor * ((unsigned long long)weight + 1u);
+}
+
+static int CompareScoreDesc(const void *a, const void *b) {
+    unsigned long long x = *(const unsigned long long*)a, y = *(const unsigned long long*)b;
+    return x != y ? (x > y ? -1 : 1) : 0;
+}
+
+static int CompareString(const void *a, const void *b) {
+    return strcmp(*(const char *const *)a, *(const char *const *)b);
+}
+
+/* Brute-force score of a suggested word (0: not a candidate). */
+static unsigned long long ScoreOf(const WeightedDict *d, const char *w, const char *q) {
+    for (size_t j = 0; j < d->n; ++j)
+        if (strcmp(d->e[j].word, w) == 0) return BruteScore(w, d->e[j].weight, q);
+    return 0;
+}
+
+static int CheckRanked(TestRng *r, NonLeafPtr root, const WeightedDict *d) {
+    int failures = 0;
+    unsigned long long *scores = (unsigned long long*)malloc(d->n * sizeof(unsigned long long));
+    if (!scores) Error("out of memory: test");
+
+    for (int i = 0; i < QUERIES && failures < 10; ++i) {
+        char q[MAX_WORD + 16];
+        TestQuery(r, q, d->e[TestNext(r, (unsigned)d->n)].word, 5);
+
+        int n = 0;
+        for (size_t j = 0; j < d->n; ++j) {
+            unsigned long long s = BruteScore(d->e[j].word, d->e[j].weight, q);
+            if (s) scores[n++] = s;
+        }
+        qsort(scores, (size_t)n, sizeof(*scores), CompareScoreDesc);
+
+        /* all candidates: SuggestCorrections' set, each once, best first */
+        SuggestBox all = { NULL, 0, 0 }, got = { NULL, 0, 0 };
+        SuggestCorrections(root, q, (int)d->n, &all);
+        SuggestCorrectionsRanked(root, q, (int)d->n, &got);
+        EXPECT(failures, got.count == n && all.count == n,
+               "`%s`: Ranked gives %d words, SuggestCorrections %d, expected %d", q, got.count,
+               all.count, n);
+        if (got.count == all.count) {
+            char **a = (char**)malloc(((size_t)n + 1) * sizeof(char*));
+            char **b = (char**)malloc(((size_t)n + 1) * sizeof(char*));
+            if (!a || !b) Error("out of memory: test");
+            memcpy(a, all.items, (size_t)all.count * sizeof(char*));
+            memcpy(b, got.items, (size_t)got.count * sizeof(char*));
+            qsort(a, (size_t)all.count, sizeof(char*), CompareString);
+            qsort(b, (size_t)got.count, sizeof(char*), CompareString);
+            for (int j = 0; j < got.count; ++j)
+                EXPECT(failures, strcmp(a[j], b[j]) == 0 && (j == 0 || strcmp(b[j - 1], b[j]) != 0),
+                       "`%s`: Ranked and SuggestCorrections differ at `%s` / `%s`", q, b[j], a[j]);
+            free(a);
+            free(b);
+        }
+        for (int j = 0; j < got.count && j < n; ++j)
+            EXPECT(failures, ScoreOf(d, got.items[j], q) == scores[j],
+                   "`%s`: Ranked #%d is `%s` scoring %llu, expected a score of %llu", q, j,
+                   got.items[j], ScoreOf(d, got.items[j], q), scores[j]);
+        FreeSuggestBox(&all);
+        FreeSuggestBox(&got);
+
+        /* a few: the best scores */
+        for (size_t m = 0; m < sizeof(RANKED_MAX) / sizeof(RANKED_MAX[0]); ++m) {
+            int want = n < RANKED_MAX[m] ? n : RANKED_MAX[m];
+            SuggestCorrectionsRanked(root, q, RANKED_MAX[m], &got);
+            EXPECT(failures, got.count == want, "`%s`, max %d: Ranked gives %d words, expected %d",
+                   q, RANKED_MAX[m], got.count, want);
+            for (int j = 0; j < got.count && j < want; ++j)
+                EXPECT(failures, ScoreOf(d, got.items[j], q) == scores[j],
+                       "`%s`, max %d: #%d is `%s` scoring %llu, expected a score of %llu", q,
+                       RANKED_MAX[m], j, got.items[j], ScoreOf(d, got.items[j], q), scores[j]);
+            FreeSuggestBox(&got);
+        }
+    }
+
+    free(scores);
+    return failures;
+}
+
+int TestRanked(void) {
+    TestRng r;
+    r.s = 0x72616e6b6564ull;
+
+    WeightedDict d;
+    NonLeafPtr root = BuildWeighted(&r, &d);
+    int failures = CheckRanked(&r, root, &d);
+
+    TrieDestroy(root);
+    free(d.e);
+    return failures;
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include "SimpleTrieSpellChecker.h"
+#include <stdio.h>
+
+/* ================================================================ *
+ * Regression tests (one executable, one CTest entry per test)      *
+ *                                                                  *
+ * Every test is a function returning its number of failures; the  *
+ * runner in test_main.c picks one by name. Diagnostics go to       *
+ * stderr, so a test may redirect stdout (TrieSideView dumps).      *
+ * Inputs come from a fixed-seed PRNG: every run checks the same    *
+ * words and text on every platform.                                *
+ * ================================================================ */
+
+int TestSpellCheckParallel(void);
+int TestDeleteIndex(void);
+int TestParallelBuild(void);
+int TestLongWords(void);
+int TestTrieRemove(void);
+int TestLiveTrie(void);
+int TestPacked(void);
+int TestFrozen(void);
+int TestComplete(void);
+int TestRanked(void);
+int TestScanner(void);
+
+/* Longest word the helpers below accept (TrieSideView path buffer). */
+#define TEST_MAX_WORD 1022
+
+/* Are the TrieSideView dumps of a and b (NULL: empty) byte for byte the
+ * same? Sizes go to *bytesA / *bytesB if non-NULL. Redirects stdout to a
+ * scratch file for good, so diagnostics must use stderr. */
+int TestSameSideView(NonLeafPtr a, NonLeafPtr b, long *bytesA, long *bytesB);
+
+/* Trie of the distinct non-empty `words` built with TrieBuildFromSorted
+ * (after sorting a copy in trie order); NULL if there are none. */
+NonLeafPtr TestBuildSorted(const char *const *words, size_t n);
+
+/* Same words in the same order? */
+int TestSameBox(const SuggestBox *a, const SuggestBox *b);
+
+/* Report a failed check and count it. */
+#define EXPECT(failures, cond, ...)                                   \
+    do {                                                              \
+        if (!(cond)) {                                                \
+            fprintf(stderr, "  %s:%d: ", __FILE__, __LINE__);         \
+            fprintf(stderr, __VA_ARGS__);                             \
+            fputc('\n', stderr);                                      \
+            ++(failures);                                             \
+        }                                                             \
+    } while (0)
+
+/* Deterministic generator (xorshift64*). */
+typedef struct {
+    unsigned long long s;
+} TestRng;
+
+static inline unsigned TestNext(TestRng *r, unsigned bound) {
+    r->s ^= r->s >> 12;
+    r->s ^= r->s << 25;
+    r->s ^= r->s >> 27;
+    return (unsigned)((r->s * 2685821657736338717ull) >> 33) % bound;
+}
+
+/* Random word of `minLen`..`maxLen` letters from the first `alphabet`
+ * of 'A'..'Z', NUL-terminated into w. */
+static inline void TestWord(TestRng *r, char *w, int minLen, int maxLen, int alphabet) {
+    int n = minLen + (int)TestNext(r, (unsigned)(maxLen - minLen + 1));
+    for (int i = 0; i < n; ++i) w[i] = (char)('A' + TestNext(r, (unsigned)alphabet));
+    w[n] = '\0';
+}
+
+/* One random edit of w (substitution, insertion, deletion or adjacent
+ * transposition, letters from the first `alphabet` of 'A'..'Z'); w needs
+ * room for one more char. */
+void TestEdit(TestRng *r, char *w, int alphabet);
+
+/* A query derived from a dictionary word: the word itself, one or two
+ * edits of it (TestEdit), one of its prefixes, or a random word. May be
+ * empty; q needs strlen(word) + 3 bytes (at least 13). */
+void TestQuery(TestRng *r, char *q, const char *word, int alphabet);